@@ -1,4 +1,5 @@
 ﻿#include "game.pch.h"
+#include "common/allocation/qp_memory_tracking.h"
 #include "common/threads/qp_thread_pool.h"
 #if defined( QP_HEADLESS )
 #include "qp/engine/core/qp_headless_app.h"
@@ -25,40 +26,48 @@ int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLin
 	}
 #endif
 
+	// the app and the thread pool are destroyed before the memory report so their memory doesn't show up in it.
+	{
 #if defined( QP_HEADLESS )
-	qpHeadlessApp app;
+		qpHeadlessApp app;
 #else
-	windowProperties_t windowProperties;
-	windowProperties.width = 800;
-	windowProperties.height = 600;
-	windowProperties.allowResize = true;
-	windowProperties.mode = windowMode_t::WINDOWED;
+		windowProperties_t windowProperties;
+		windowProperties.width = 800;
+		windowProperties.height = 600;
+		windowProperties.allowResize = true;
+		windowProperties.mode = windowMode_t::WINDOWED;
 #if defined( QP_VULKAN )
-	windowProperties.title = "qpVulkan Window Win32";
+		windowProperties.title = "qpVulkan Window Win32";
 #elif defined( QP_D3D11 )
-	windowProperties.title = "qpD3D11 Window Win32";
+		windowProperties.title = "qpD3D11 Window Win32";
 #endif
-	windowPropertiesWindows_t windowsProperties;
-	windowsProperties.instanceHandle = hInstance;
+		windowPropertiesWindows_t windowsProperties;
+		windowsProperties.instanceHandle = hInstance;
 
-	windowProperties.platformData = &windowsProperties;
+		windowProperties.platformData = &windowsProperties;
 
-	qpGameApp app( windowProperties );
+		qpGameApp app( windowProperties );
 #endif
 
-	qpThreadPool threadPool;
-	threadPool.Startup( threadPool.MaxWorkers() );
+		qpThreadPool threadPool;
+		threadPool.Startup( threadPool.MaxWorkers() );
+		app.SetThreadPool( &threadPool );
 	
-	threadPool.QueueJob( []() { qpDebug::Printf( "I'm just thread I like to work :)\n" ); } );
-	threadPool.QueueJob( []() { qpDebug::Printf( "Nooooo, I don't enjoy working >:(\n" ); } );
-	try {
-		app.Run();
-	} catch ( const std::exception & e ) {
-		qpDebug::Error( "%s", e.what() );
+		threadPool.QueueJob( []() { qpDebug::Printf( "I'm just thread I like to work :)\n" ); } );
+		threadPool.QueueJob( []() { qpDebug::Printf( "Nooooo, I don't enjoy working >:(\n" ); } );
+		try {
+			app.Run();
+		} catch ( const std::exception & e ) {
+			qpDebug::Error( "%s", e.what() );
+		}
+
+		threadPool.Shutdown();
+		qpDebug::Trace( "Shutting down." );
 	}
 
-	threadPool.Shutdown();
-	qpDebug::Trace( "Shutting down." );
+	qpMemoryTracking::DumpStats();
+	qpMemoryTracking::DumpStatsToFile( "memory_stats.txt" );
+	qpMemoryTracking::ReportLeaks();
 
 	qpDebug::FlushLogFile();
 	
@@ -75,30 +84,37 @@ int main() {
 	Sys_InitializeConsole();
 #endif
 
+	// the app is destroyed before the memory report so its memory doesn't show up in it.
+	{
 #if defined( QP_HEADLESS )
-	qpHeadlessApp app;
+		qpHeadlessApp app;
 #else
-	windowProperties_t windowProperties;
-	windowProperties.width = 800;
-	windowProperties.height = 600;
-	windowProperties.allowResize = true;
-	windowProperties.mode = windowMode_t::WINDOWED;
-	windowProperties.title = "qpVulkanLinuxWindow";
+		windowProperties_t windowProperties;
+		windowProperties.width = 800;
+		windowProperties.height = 600;
+		windowProperties.allowResize = true;
+		windowProperties.mode = windowMode_t::WINDOWED;
+		windowProperties.title = "qpVulkanLinuxWindow";
 
-	// windowPropertiesWindows_t windowsProperties;
-	// windowsProperties.instanceHandle = hInstance;
+		// windowPropertiesWindows_t windowsProperties;
+		// windowsProperties.instanceHandle = hInstance;
 
-	//windowProperties.platformData = &windowsProperties;
+		//windowProperties.platformData = &windowsProperties;
 
-	qpWindowedApp app( windowProperties );
+		qpWindowedApp app( windowProperties );
 #endif
 
-	try {
-		app.Run();
-	} catch ( const std::exception & e ) {
-		qpDebug::Error( "%s", e.what() );
+		try {
+			app.Run();
+		} catch ( const std::exception & e ) {
+			qpDebug::Error( "%s", e.what() );
+		}
 	}
 
+	qpMemoryTracking::DumpStats();
+	qpMemoryTracking::DumpStatsToFile( "memory_stats.txt" );
+	qpMemoryTracking::ReportLeaks();
+
 	return 0;
 }
 #else
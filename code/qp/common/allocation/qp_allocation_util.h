@@ -9,4 +9,13 @@ namespace qpAllocationUtil {
 
 		return size + ( alignment - ( size % alignment ) ) % alignment;
 	}
+
+	constexpr static bool IsPowerOfTwo( const uint64 value ) { return ( value != 0 ) && ( ( value & ( value - 1 ) ) == 0 ); }
+
+	// rounds value up to the next multiple of alignment, alignment has to be a power of two.
+	constexpr static uint64 AlignUp( const uint64 value, const uint64 alignment ) { return ( value + alignment - 1 ) & ~( alignment - 1 ); }
+
+	static byte * AlignPointer( byte * ptr, const uint64 alignment ) {
+		return reinterpret_cast< byte * >( AlignUp( reinterpret_cast< uintptr_t >( ptr ), alignment ) );
+	}
 };
@@ -0,0 +1,97 @@
+#include "engine.pch.h"
+#include "qp_allocator.h"
+#include "qp_allocation_util.h"
+#include "qp_engine_heap.h"
+#include "qp_memory_tracking.h"
+#include "qp/common/math/qp_math.h"
+#include <cstring>
+#include <new>
+
+namespace {
+	// the alignment is remembered in front of the allocation so Free doesn't need to be told about it.
+	struct heapHeader_t {
+		uint64 alignment = 0;
+	};
+
+	uint64 HeapHeaderSize( const uint64 alignment ) { return qpAllocationUtil::AlignUp( sizeof( heapHeader_t ), alignment ); }
+
+	atomic_t< qpAllocator * > s_heapOverride = NULL;
+	atomic_t< bool > s_heapUsed = false;
+
+	// forwards to whatever heap is in use so allocators that were created before the override still end up there.
+	class qpHeapRouter : public qpAllocator {
+	public:
+		virtual void * Allocate( const uint64 size, const uint64 alignment ) override {
+			if ( !s_heapUsed.load( std::memory_order_relaxed ) ) {
+				s_heapUsed.store( true, std::memory_order_relaxed );
+			}
+			return GetHeap().Allocate( size, alignment );
+		}
+		virtual void Free( void * ptr, const uint64 size ) override { GetHeap().Free( ptr, size ); }
+		virtual void * Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment ) override { return GetHeap().Reallocate( ptr, oldSize, newSize, alignment ); }
+	private:
+		static qpAllocator & GetHeap() {
+			qpAllocator * heapOverride = s_heapOverride.load( std::memory_order_relaxed );
+			return ( heapOverride != NULL ) ? *heapOverride : qpGetEngineHeap();
+		}
+	};
+}
+
+void * qpAllocator::Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment ) {
+	if ( ptr == NULL ) {
+		return Allocate( newSize, alignment );
+	}
+	void * newPtr = Allocate( newSize, alignment );
+	if ( newPtr == NULL ) {
+		return NULL;
+	}
+	memcpy( newPtr, ptr, qpMath::Min( oldSize, newSize ) );
+	Free( ptr, oldSize );
+	return newPtr;
+}
+
+void * qpSystemAllocator::Allocate( const uint64 size, const uint64 alignment ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( alignment ), "Alignment has to be a power of two." );
+	const uint64 headerSize = HeapHeaderSize( alignment );
+	byte * memory = static_cast< byte * >( ::operator new( headerSize + size, std::align_val_t( alignment ), std::nothrow ) );
+	if ( memory == NULL ) {
+		return NULL;
+	}
+	byte * ptr = memory + headerSize;
+	new ( ptr - sizeof( heapHeader_t ) ) heapHeader_t { alignment };
+	return ptr;
+}
+
+void qpSystemAllocator::Free( void * ptr, const uint64 ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	const heapHeader_t * header = reinterpret_cast< const heapHeader_t * >( static_cast< byte * >( ptr ) - sizeof( heapHeader_t ) );
+	const uint64 alignment = header->alignment;
+	::operator delete( static_cast< byte * >( ptr ) - HeapHeaderSize( alignment ), std::align_val_t( alignment ) );
+}
+
+qpAllocator & qpGetSystemAllocator() {
+	// never destroyed so containers that outlive static destruction can still free their memory.
+	static qpSystemAllocator * systemAllocator = new qpSystemAllocator();
+	return *systemAllocator;
+}
+
+qpAllocator & qpGetHeap() {
+	static qpHeapRouter * heapRouter = new qpHeapRouter();
+	return *heapRouter;
+}
+
+void qpSetHeapOverride( qpAllocator * allocator ) {
+	QP_ASSERT_MSG( !s_heapUsed.load(), "The heap can't be overridden once something has been allocated from it." );
+	s_heapOverride.store( allocator );
+}
+
+qpAllocator & qpGetDefaultAllocator() {
+#if defined( QP_MEMORY_TRACKING )
+	static qpTrackedAllocator * defaultAllocator = new qpTrackedAllocator( qpGetHeap() );
+	return *defaultAllocator;
+#else
+	return qpGetHeap();
+#endif
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "qp/common/core/qp_types.h"
+#include <cstddef>
+
+// Interface containers allocate their memory through so the same container type can be backed by
+// the default heap, an arena or a tracked heap depending on who owns it.
+class qpAllocator {
+public:
+	virtual ~qpAllocator() = default;
+
+	// returns NULL when the allocator is out of memory.
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) = 0;
+	// size has to be the size the memory was allocated with.
+	virtual void Free( void * ptr, const uint64 size ) = 0;
+	// resizes an allocation, moving it when it can't be grown in place. the contents are copied bytewise so
+	// only use it for memory holding trivially relocatable data. returns NULL and keeps ptr when out of memory.
+	virtual void * Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment = alignof( std::max_align_t ) );
+};
+
+// allocator that goes straight to the c runtime heap.
+class qpSystemAllocator : public qpAllocator {
+public:
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) override;
+	virtual void Free( void * ptr, const uint64 size ) override;
+};
+
+qpAllocator & qpGetSystemAllocator();
+
+// the heap the default allocator and the memory category allocators allocate from, the engine heap unless overridden.
+qpAllocator & qpGetHeap();
+// replaces the engine heap, e.g. with the system allocator in tests. has to be set before anything
+// has been allocated from the heap, NULL goes back to the engine heap.
+void qpSetHeapOverride( qpAllocator * allocator );
+
+// allocator containers use when they aren't given one.
+qpAllocator & qpGetDefaultAllocator();
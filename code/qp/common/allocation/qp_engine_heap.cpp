@@ -0,0 +1,292 @@
+#include "engine.pch.h"
+#include "qp_engine_heap.h"
+#include "qp_allocation_util.h"
+#include "qp/common/math/qp_math.h"
+#include <mutex>
+#include <new>
+
+namespace {
+	// 16 byte steps up to 128 bytes and then two classes per power of two.
+	constexpr uint32 s_sizeClasses[] = {
+		16, 32, 48, 64, 80, 96, 112, 128,
+		192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096,
+		6144, 8192, 12288, 16384, 24576, 32768
+	};
+	constexpr uint32 s_numSizeClasses = sizeof( s_sizeClasses ) / sizeof( s_sizeClasses[ 0 ] );
+	QP_COMPILE_TIME_ASSERT( s_sizeClasses[ s_numSizeClasses - 1 ] == qpEngineHeap::MAX_SMALL_ALLOCATION_SIZE );
+
+	const uint64 s_sizeClassGranularity = 16;
+	// spans are aligned to their size so the span of a block is found by masking its address.
+	const uint64 s_spanSize = 256 * 1024;
+	const uint64 s_spansPerRegion = 256;
+	// blocks moved between a thread cache and the backend at once.
+	const uint32 s_maxTransferBatch = 64;
+	const uint32 s_minTransferBatch = 4;
+
+	struct sizeClassLookup_t {
+		uint8 classes[ qpEngineHeap::MAX_SMALL_ALLOCATION_SIZE / s_sizeClassGranularity + 1 ] {};
+
+		constexpr sizeClassLookup_t() {
+			uint32 sizeClass = 0;
+			for ( uint32 index = 0; index < sizeof( classes ); ++index ) {
+				while ( s_sizeClasses[ sizeClass ] < index * s_sizeClassGranularity ) {
+					++sizeClass;
+				}
+				classes[ index ] = static_cast< uint8 >( sizeClass );
+			}
+		}
+	};
+	constexpr sizeClassLookup_t s_sizeClassLookup;
+
+	struct freeBlock_t {
+		freeBlock_t * next = NULL;
+	};
+
+	struct spanHeader_t {
+		uint32 sizeClass = 0;
+	};
+
+	struct sharedSizeClass_t {
+		std::mutex mutex;
+		freeBlock_t * freeList = NULL;
+		uint32 numFree = 0;
+	};
+
+	struct sharedBackend_t {
+		alignas( 64 ) sharedSizeClass_t sizeClasses[ s_numSizeClasses ];
+		std::mutex spanMutex;
+		byte * regionCursor = NULL;
+		byte * regionEnd = NULL;
+		atomicUInt64_t numSpans = 0;
+	};
+	// only constant initialized members so it is usable before any dynamic initialization has run.
+	sharedBackend_t s_backend;
+
+	struct cachedSizeClass_t {
+		freeBlock_t * freeList = NULL;
+		uint32 numFree = 0;
+	};
+	struct threadCache_t {
+		cachedSizeClass_t sizeClasses[ s_numSizeClasses ];
+	};
+	// trivially destructible so it stays usable while other thread locals are destroyed, the releaser
+	// below gives the blocks back when the thread exits and any frees after that go straight to the backend.
+	thread_local threadCache_t t_threadCache;
+	thread_local bool t_threadCacheReleased = false;
+	struct threadCacheReleaser_t {
+		~threadCacheReleaser_t() {
+			qpEngineHeap::FlushThreadCache();
+			t_threadCacheReleased = true;
+		}
+	};
+	thread_local threadCacheReleaser_t t_threadCacheReleaser;
+
+	uint32 SizeClassIndex( const uint64 size, const uint64 alignment ) {
+		uint32 sizeClass = s_sizeClassLookup.classes[ ( qpMath::Max( size, alignment ) + s_sizeClassGranularity - 1 ) / s_sizeClassGranularity ];
+		if ( alignment > s_sizeClassGranularity ) {
+			// blocks are aligned to the largest power of two their size is a multiple of.
+			while ( ( s_sizeClasses[ sizeClass ] % alignment ) != 0 ) {
+				++sizeClass;
+			}
+		}
+		return sizeClass;
+	}
+
+	uint32 TransferBatchSize( const uint32 sizeClass ) {
+		return qpMath::Clamp( static_cast< uint32 >( s_spanSize / 8 / s_sizeClasses[ sizeClass ] ), s_minTransferBatch, s_maxTransferBatch );
+	}
+
+	uint64 SpanHeaderSize( const uint32 sizeClass ) {
+		const uint64 blockSize = s_sizeClasses[ sizeClass ];
+		const uint64 blockAlignment = qpMath::Min( blockSize & ( ~blockSize + 1 ), static_cast< uint64 >( Sys_PageSize() ) );
+		return qpAllocationUtil::AlignUp( sizeof( spanHeader_t ), blockAlignment );
+	}
+
+	spanHeader_t * GetSpan( const void * ptr ) {
+		return reinterpret_cast< spanHeader_t * >( reinterpret_cast< uintptr_t >( ptr ) & ~( s_spanSize - 1 ) );
+	}
+
+	byte * AllocateSpan() {
+		std::scoped_lock lock( s_backend.spanMutex );
+		if ( s_backend.regionCursor == s_backend.regionEnd ) {
+			// over reserve by a span so the region can be aligned to the span size.
+			const uint64 regionSize = s_spanSize * s_spansPerRegion;
+			byte * region = static_cast< byte * >( Sys_ReserveMemory( regionSize + s_spanSize ) );
+			if ( region == NULL ) {
+				return NULL;
+			}
+			s_backend.regionCursor = qpAllocationUtil::AlignPointer( region, s_spanSize );
+			s_backend.regionEnd = s_backend.regionCursor + regionSize;
+		}
+		byte * span = s_backend.regionCursor;
+		if ( !Sys_CommitMemory( span, s_spanSize ) ) {
+			return NULL;
+		}
+		s_backend.regionCursor += s_spanSize;
+		s_backend.numSpans.fetch_add( 1, std::memory_order_relaxed );
+		return span;
+	}
+
+	// carves a new span into blocks for the size class, has to be called with the size class locked.
+	bool AddSpan( sharedSizeClass_t & shared, const uint32 sizeClass ) {
+		byte * span = AllocateSpan();
+		if ( span == NULL ) {
+			return false;
+		}
+		new ( span ) spanHeader_t { sizeClass };
+		const uint64 blockSize = s_sizeClasses[ sizeClass ];
+		const uint64 headerSize = SpanHeaderSize( sizeClass );
+		const uint64 numBlocks = ( s_spanSize - headerSize ) / blockSize;
+		// pushed back to front so blocks are handed out in address order.
+		for ( uint64 index = numBlocks; index > 0; --index ) {
+			freeBlock_t * block = new ( span + headerSize + ( index - 1 ) * blockSize ) freeBlock_t();
+			block->next = shared.freeList;
+			shared.freeList = block;
+		}
+		shared.numFree += static_cast< uint32 >( numBlocks );
+		return true;
+	}
+
+	void * AllocateShared( const uint32 sizeClass ) {
+		sharedSizeClass_t & shared = s_backend.sizeClasses[ sizeClass ];
+		std::scoped_lock lock( shared.mutex );
+		if ( ( shared.freeList == NULL ) && !AddSpan( shared, sizeClass ) ) {
+			return NULL;
+		}
+		freeBlock_t * block = shared.freeList;
+		shared.freeList = block->next;
+		--shared.numFree;
+		return block;
+	}
+
+	void FreeShared( const uint32 sizeClass, freeBlock_t * first, freeBlock_t * last, const uint32 numBlocks ) {
+		sharedSizeClass_t & shared = s_backend.sizeClasses[ sizeClass ];
+		std::scoped_lock lock( shared.mutex );
+		last->next = shared.freeList;
+		shared.freeList = first;
+		shared.numFree += numBlocks;
+	}
+
+	bool RefillThreadCache( cachedSizeClass_t & cached, const uint32 sizeClass ) {
+		sharedSizeClass_t & shared = s_backend.sizeClasses[ sizeClass ];
+		const uint32 batchSize = TransferBatchSize( sizeClass );
+		std::scoped_lock lock( shared.mutex );
+		if ( ( shared.numFree < batchSize ) && !AddSpan( shared, sizeClass ) && ( shared.freeList == NULL ) ) {
+			return false;
+		}
+		for ( uint32 index = 0; ( index < batchSize ) && ( shared.freeList != NULL ); ++index ) {
+			freeBlock_t * block = shared.freeList;
+			shared.freeList = block->next;
+			--shared.numFree;
+			block->next = cached.freeList;
+			cached.freeList = block;
+			++cached.numFree;
+		}
+		return true;
+	}
+
+	void DrainThreadCache( cachedSizeClass_t & cached, const uint32 sizeClass, const uint32 numBlocks ) {
+		freeBlock_t * first = cached.freeList;
+		freeBlock_t * last = first;
+		for ( uint32 index = 1; index < numBlocks; ++index ) {
+			last = last->next;
+		}
+		cached.freeList = last->next;
+		cached.numFree -= numBlocks;
+		FreeShared( sizeClass, first, last, numBlocks );
+	}
+
+	void * AllocateLarge( const uint64 size ) {
+		const uint64 pagedSize = qpAllocationUtil::AlignUp( size, Sys_PageSize() );
+		void * memory = Sys_ReserveMemory( pagedSize );
+		if ( memory == NULL ) {
+			return NULL;
+		}
+		if ( !Sys_CommitMemory( memory, pagedSize ) ) {
+			Sys_ReleaseMemory( memory, pagedSize );
+			return NULL;
+		}
+		return memory;
+	}
+}
+
+void * qpEngineHeap::Allocate( const uint64 size, const uint64 alignment ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( alignment ) && ( alignment <= Sys_PageSize() ), "Alignment has to be a power of two no bigger than the page size." );
+	if ( size > MAX_SMALL_ALLOCATION_SIZE ) {
+		return AllocateLarge( size );
+	}
+
+	const uint32 sizeClass = SizeClassIndex( size, alignment );
+	if ( t_threadCacheReleased ) {
+		return AllocateShared( sizeClass );
+	}
+	// touching the releaser makes sure it is constructed and destroyed with the thread.
+	QP_DISCARD_RESULT &t_threadCacheReleaser;
+	cachedSizeClass_t & cached = t_threadCache.sizeClasses[ sizeClass ];
+	if ( ( cached.freeList == NULL ) && !RefillThreadCache( cached, sizeClass ) ) {
+		return NULL;
+	}
+	freeBlock_t * block = cached.freeList;
+	cached.freeList = block->next;
+	--cached.numFree;
+	return block;
+}
+
+void qpEngineHeap::Free( void * ptr, const uint64 size ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	if ( size > MAX_SMALL_ALLOCATION_SIZE ) {
+		Sys_ReleaseMemory( ptr, qpAllocationUtil::AlignUp( size, Sys_PageSize() ) );
+		return;
+	}
+
+	// the size class is looked up in the span since the alignment the block was allocated with isn't known here.
+	const uint32 sizeClass = GetSpan( ptr )->sizeClass;
+	QP_ASSERT_MSG( s_sizeClasses[ sizeClass ] >= size, "Freeing a block with a bigger size than it was allocated with." );
+	freeBlock_t * block = new ( ptr ) freeBlock_t();
+	if ( t_threadCacheReleased ) {
+		FreeShared( sizeClass, block, block, 1 );
+		return;
+	}
+	cachedSizeClass_t & cached = t_threadCache.sizeClasses[ sizeClass ];
+	block->next = cached.freeList;
+	cached.freeList = block;
+	++cached.numFree;
+	const uint32 batchSize = TransferBatchSize( sizeClass );
+	if ( cached.numFree > batchSize * 2 ) {
+		DrainThreadCache( cached, sizeClass, batchSize );
+	}
+}
+
+void * qpEngineHeap::Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment ) {
+	if ( ptr != NULL ) {
+		const bool wasSmall = oldSize <= MAX_SMALL_ALLOCATION_SIZE;
+		const bool isSmall = newSize <= MAX_SMALL_ALLOCATION_SIZE;
+		if ( wasSmall && isSmall && ( SizeClassIndex( newSize, alignment ) == GetSpan( ptr )->sizeClass ) ) {
+			return ptr;
+		}
+		if ( !wasSmall && !isSmall && ( qpAllocationUtil::AlignUp( newSize, Sys_PageSize() ) == qpAllocationUtil::AlignUp( oldSize, Sys_PageSize() ) ) ) {
+			return ptr;
+		}
+	}
+	return qpAllocator::Reallocate( ptr, oldSize, newSize, alignment );
+}
+
+void qpEngineHeap::FlushThreadCache() {
+	for ( uint32 sizeClass = 0; sizeClass < s_numSizeClasses; ++sizeClass ) {
+		cachedSizeClass_t & cached = t_threadCache.sizeClasses[ sizeClass ];
+		if ( cached.numFree > 0 ) {
+			DrainThreadCache( cached, sizeClass, cached.numFree );
+		}
+	}
+}
+
+uint64 qpEngineHeap::NumSpans() {
+	return s_backend.numSpans.load( std::memory_order_relaxed );
+}
+
+qpEngineHeap & qpGetEngineHeap() {
+	static qpEngineHeap * engineHeap = new qpEngineHeap();
+	return *engineHeap;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_types.h"
+
+// General purpose heap for the engine.
+// Small allocations are rounded up to a size class and every thread caches free blocks per class, so most
+// allocations and frees never touch shared state. Threads refill and drain their caches in batches from a shared
+// backend that carves blocks out of spans of virtual memory. Large allocations get their own pages from the os.
+// Spans are never given back to the os, freed blocks are reused by any thread instead.
+// Alignments up to the page size are supported.
+class qpEngineHeap : public qpAllocator {
+public:
+	enum : uint64 {
+		MAX_SMALL_ALLOCATION_SIZE = 32 * 1024
+	};
+
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) override;
+	virtual void Free( void * ptr, const uint64 size ) override;
+	// stays in place while the new size rounds to the same size class, or the same pages for large allocations.
+	virtual void * Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment = alignof( std::max_align_t ) ) override;
+
+	// gives the calling thread's cached blocks back to the shared backend, done automatically when a thread exits.
+	static void FlushThreadCache();
+
+	static uint64 NumSpans();
+};
+
+qpEngineHeap & qpGetEngineHeap();
@@ -0,0 +1,39 @@
+#include "engine.pch.h"
+#include "qp_linear_allocator.h"
+#include "qp/common/math/qp_math.h"
+
+namespace {
+	// cache line aligned so allocations with bigger alignments than the default don't waste the start of the arena.
+	const uint64 s_arenaAlignment = 64;
+}
+
+qpLinearAllocator::qpLinearAllocator( const uint64 capacity ) : m_capacity( capacity ) {
+	m_memory = static_cast< byte * >( ::operator new( capacity, std::align_val_t( s_arenaAlignment ) ) );
+}
+
+qpLinearAllocator::~qpLinearAllocator() {
+	::operator delete( m_memory, std::align_val_t( s_arenaAlignment ) );
+}
+
+void * qpLinearAllocator::Allocate( const uint64 size, const uint64 alignment ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( alignment ), "Alignment has to be a power of two." );
+	const uint64 offset = static_cast< uint64 >( qpAllocationUtil::AlignPointer( m_memory + m_bytesAllocated, alignment ) - m_memory );
+	if ( ( offset > m_capacity ) || ( size > m_capacity - offset ) ) {
+		qpDebug::Error( "LinearAllocator: Out of memory allocating %llu bytes, %llu of %llu bytes are in use.", size, m_bytesAllocated, m_capacity );
+		return NULL;
+	}
+	m_bytesAllocated = offset + size;
+	m_peakBytesAllocated = qpMath::Max( m_peakBytesAllocated, m_bytesAllocated );
+	return m_memory + offset;
+}
+
+void qpLinearAllocator::Free( void * ptr, const uint64 size ) {
+	if ( ( ptr != NULL ) && ( static_cast< byte * >( ptr ) + size == m_memory + m_bytesAllocated ) ) {
+		m_bytesAllocated -= size;
+	}
+}
+
+void qpLinearAllocator::RewindToMarker( const marker_t marker ) {
+	QP_ASSERT_MSG( marker.offset <= m_bytesAllocated, "Rewinding to a marker that has already been rewound past." );
+	m_bytesAllocated = qpMath::Min( marker.offset, m_bytesAllocated );
+}
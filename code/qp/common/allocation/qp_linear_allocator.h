@@ -0,0 +1,84 @@
+#pragma once
+#include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <cstddef>
+#include <new>
+
+// Bump allocator for short lived allocations such as everything that only has to live for a frame.
+// Allocating is a pointer bump and everything is freed at once with Reset or by rewinding to a marker.
+// Destructors are never run, only put types in here that don't need them or destroy them yourself.
+class qpLinearAllocator : public qpAllocator {
+public:
+	struct marker_t {
+		uint64 offset = 0;
+	};
+
+	explicit qpLinearAllocator( const uint64 capacity );
+	virtual ~qpLinearAllocator() override;
+
+	qpLinearAllocator( const qpLinearAllocator & other ) = delete;
+	qpLinearAllocator & operator=( const qpLinearAllocator & other ) = delete;
+
+	// returns NULL when the arena is out of memory.
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) override;
+	// individual allocations aren't freed, except the most recent one which is just rolled back.
+	virtual void Free( void * ptr, const uint64 size ) override;
+
+	template < typename _type_, typename ... _args_ >
+	_type_ * New( _args_ &&... args );
+	// default constructs count items.
+	template < typename _type_ >
+	_type_ * NewArray( const uint64 count );
+
+	marker_t GetMarker() const { return marker_t { m_bytesAllocated }; }
+	// frees everything allocated after the marker was taken.
+	void RewindToMarker( const marker_t marker );
+	void Reset() { m_bytesAllocated = 0; }
+
+	bool Owns( const void * ptr ) const { return ( ptr >= m_memory ) && ( ptr < m_memory + m_capacity ); }
+	uint64 Capacity() const { return m_capacity; }
+	uint64 BytesAllocated() const { return m_bytesAllocated; }
+	uint64 PeakBytesAllocated() const { return m_peakBytesAllocated; }
+private:
+	byte * m_memory = NULL;
+	uint64 m_capacity = 0;
+	uint64 m_bytesAllocated = 0;
+	uint64 m_peakBytesAllocated = 0;
+};
+
+template < typename _type_, typename ... _args_ >
+_type_ * qpLinearAllocator::New( _args_ &&... args ) {
+	void * memory = Allocate( sizeof( _type_ ), alignof( _type_ ) );
+	if ( memory == NULL ) {
+		return NULL;
+	}
+	return new ( memory ) _type_( qpForward< _args_ >( args )... );
+}
+
+template < typename _type_ >
+_type_ * qpLinearAllocator::NewArray( const uint64 count ) {
+	_type_ * items = static_cast< _type_ * >( Allocate( sizeof( _type_ ) * count, alignof( _type_ ) ) );
+	if ( items == NULL ) {
+		return NULL;
+	}
+	for ( uint64 index = 0; index < count; ++index ) {
+		new ( &items[ index ] ) _type_();
+	}
+	return items;
+}
+
+// rewinds the allocator to where it was when the scope was entered.
+class qpLinearAllocatorScope {
+public:
+	explicit qpLinearAllocatorScope( qpLinearAllocator & allocator ) : m_allocator( allocator ), m_marker( allocator.GetMarker() ) {}
+	~qpLinearAllocatorScope() { m_allocator.RewindToMarker( m_marker ); }
+
+	qpLinearAllocatorScope( const qpLinearAllocatorScope & other ) = delete;
+	qpLinearAllocatorScope & operator=( const qpLinearAllocatorScope & other ) = delete;
+private:
+	qpLinearAllocator & m_allocator;
+	qpLinearAllocator::marker_t m_marker;
+};
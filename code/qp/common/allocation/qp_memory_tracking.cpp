@@ -0,0 +1,265 @@
+#include "engine.pch.h"
+#include "qp_memory_tracking.h"
+#include "qp_allocation_util.h"
+#include "qp/common/containers/qp_list.h"
+#include "qp/common/math/qp_math.h"
+#include <bit>
+#include <mutex>
+
+#if defined( QP_MEMORY_TRACKING )
+namespace {
+	struct categoryCounters_t {
+		atomicUInt64_t liveBytes = 0;
+		atomicUInt64_t peakBytes = 0;
+		atomicUInt64_t numLiveAllocations = 0;
+		atomicUInt64_t numAllocations = 0;
+		atomicUInt64_t sizeHistogram[ MEMORY_SIZE_HISTOGRAM_BUCKETS ] {};
+	};
+	categoryCounters_t s_categoryCounters[ static_cast< int >( memoryCategory_t::COUNT ) ];
+
+	thread_local memoryCategory_t s_currentCategory = memoryCategory_t::GENERAL;
+
+	struct trackedObject_t {
+		const void * object = NULL;
+		memoryCategory_t category = memoryCategory_t::GENERAL;
+		char name[ 128 ] {};
+	};
+	struct trackedObjects_t {
+		std::mutex mutex;
+		qpList< trackedObject_t > objects;
+
+		explicit trackedObjects_t( qpAllocator & allocator ) : objects( allocator ) {}
+	};
+
+	// the tracking bookkeeping itself isn't tracked.
+	qpAllocator & GetUntrackedAllocator() {
+		return qpGetSystemAllocator();
+	}
+
+	trackedObjects_t & GetTrackedObjects() {
+		static trackedObjects_t * trackedObjects = new trackedObjects_t( GetUntrackedAllocator() );
+		return *trackedObjects;
+	}
+
+	struct allocationHeader_t {
+		uint64 size = 0;
+		uint32 alignment = 0;
+		memoryCategory_t category = memoryCategory_t::GENERAL;
+	};
+
+	uint64 AllocationHeaderSize( const uint64 alignment ) { return qpAllocationUtil::AlignUp( sizeof( allocationHeader_t ), alignment ); }
+
+	uint32 SizeHistogramBucket( const uint64 size ) {
+		const int bucket = static_cast< int >( std::bit_width( qpMath::Max( size, 1ull ) - 1 ) ) - 4;
+		return static_cast< uint32 >( qpMath::Clamp( bucket, 0, static_cast< int >( MEMORY_SIZE_HISTOGRAM_BUCKETS ) - 1 ) );
+	}
+
+	// writes the stats of a category as a couple of lines, returns false if the category has never allocated anything.
+	bool FormatCategoryStats( const memoryCategory_t category, char * buffer, const uint64 bufferSize ) {
+		const memoryCategoryStats_t stats = qpMemoryTracking::GetStats( category );
+		if ( stats.numAllocations == 0 ) {
+			return false;
+		}
+		int length = snprintf( buffer, bufferSize, "%-10s live %llu bytes in %llu allocations, peak %llu bytes, %llu allocations in total\n\tsizes:",
+			qpMemoryTracking::CategoryName( category ), stats.liveBytes, stats.numLiveAllocations, stats.peakBytes, stats.numAllocations );
+		for ( uint32 bucket = 0; ( bucket < MEMORY_SIZE_HISTOGRAM_BUCKETS ) && ( length > 0 ) && ( static_cast< uint64 >( length ) < bufferSize ); ++bucket ) {
+			if ( stats.sizeHistogram[ bucket ] != 0 ) {
+				const char * bucketFormat = ( bucket == MEMORY_SIZE_HISTOGRAM_BUCKETS - 1 ) ? " >%llu: %llu" : " <=%llu: %llu";
+				const uint64 bucketSize = ( bucket == MEMORY_SIZE_HISTOGRAM_BUCKETS - 1 ) ? ( 16ull << ( bucket - 1 ) ) : ( 16ull << bucket );
+				length += snprintf( buffer + length, bufferSize - length, bucketFormat, bucketSize, stats.sizeHistogram[ bucket ] );
+			}
+		}
+		return true;
+	}
+}
+
+namespace qpMemoryTracking {
+	const char * CategoryName( const memoryCategory_t category ) {
+		switch ( category ) {
+			case memoryCategory_t::GENERAL: return "GENERAL";
+			case memoryCategory_t::STRING: return "STRING";
+			case memoryCategory_t::RESOURCE: return "RESOURCE";
+			case memoryCategory_t::RENDERER: return "RENDERER";
+			case memoryCategory_t::COUNT: break;
+		}
+		return "<UNKNOWN>";
+	}
+
+	void OnAllocate( const memoryCategory_t category, const uint64 size ) {
+		categoryCounters_t & counters = s_categoryCounters[ static_cast< int >( category ) ];
+		const uint64 liveBytes = counters.liveBytes.fetch_add( size, std::memory_order_relaxed ) + size;
+		uint64 peakBytes = counters.peakBytes.load( std::memory_order_relaxed );
+		while ( ( liveBytes > peakBytes ) && !counters.peakBytes.compare_exchange_weak( peakBytes, liveBytes, std::memory_order_relaxed ) ) {
+		}
+		counters.numLiveAllocations.fetch_add( 1, std::memory_order_relaxed );
+		counters.numAllocations.fetch_add( 1, std::memory_order_relaxed );
+		counters.sizeHistogram[ SizeHistogramBucket( size ) ].fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	void OnFree( const memoryCategory_t category, const uint64 size ) {
+		categoryCounters_t & counters = s_categoryCounters[ static_cast< int >( category ) ];
+		counters.liveBytes.fetch_sub( size, std::memory_order_relaxed );
+		counters.numLiveAllocations.fetch_sub( 1, std::memory_order_relaxed );
+	}
+
+	memoryCategoryStats_t GetStats( const memoryCategory_t category ) {
+		const categoryCounters_t & counters = s_categoryCounters[ static_cast< int >( category ) ];
+		memoryCategoryStats_t stats;
+		stats.liveBytes = counters.liveBytes.load( std::memory_order_relaxed );
+		stats.peakBytes = counters.peakBytes.load( std::memory_order_relaxed );
+		stats.numLiveAllocations = counters.numLiveAllocations.load( std::memory_order_relaxed );
+		stats.numAllocations = counters.numAllocations.load( std::memory_order_relaxed );
+		for ( uint32 bucket = 0; bucket < MEMORY_SIZE_HISTOGRAM_BUCKETS; ++bucket ) {
+			stats.sizeHistogram[ bucket ] = counters.sizeHistogram[ bucket ].load( std::memory_order_relaxed );
+		}
+		return stats;
+	}
+
+	memoryCategory_t GetCurrentCategory() {
+		return s_currentCategory;
+	}
+
+	void SetCurrentCategory( const memoryCategory_t category ) {
+		s_currentCategory = category;
+	}
+
+	void TrackObject( const void * object, const memoryCategory_t category, const char * name ) {
+		trackedObjects_t & trackedObjects = GetTrackedObjects();
+		std::scoped_lock lock( trackedObjects.mutex );
+		trackedObject_t & trackedObject = trackedObjects.objects.Emplace();
+		trackedObject.object = object;
+		trackedObject.category = category;
+		QP_DISCARD_RESULT snprintf( trackedObject.name, sizeof( trackedObject.name ), "%s", ( name != NULL ) ? name : "<unnamed>" );
+	}
+
+	void UntrackObject( const void * object ) {
+		trackedObjects_t & trackedObjects = GetTrackedObjects();
+		std::scoped_lock lock( trackedObjects.mutex );
+		for ( uint64 index = 0; index < trackedObjects.objects.Length(); ++index ) {
+			if ( trackedObjects.objects[ index ].object == object ) {
+				trackedObjects.objects[ index ] = trackedObjects.objects.Last();
+				trackedObjects.objects.Pop();
+				return;
+			}
+		}
+	}
+
+	void DumpStats() {
+		char buffer[ 1024 ] {};
+		qpDebug::Printf( "Memory stats:\n" );
+		for ( int category = 0; category < static_cast< int >( memoryCategory_t::COUNT ); ++category ) {
+			if ( FormatCategoryStats( static_cast< memoryCategory_t >( category ), buffer, sizeof( buffer ) ) ) {
+				qpDebug::Printf( "\t%s\n", buffer );
+			}
+		}
+	}
+
+	bool DumpStatsToFile( const char * filePath ) {
+		FILE * file = fopen( filePath, "w" );
+		if ( file == NULL ) {
+			qpDebug::Warning( "MemoryTracking: Failed to open \"%s\" for writing memory stats.", filePath );
+			return false;
+		}
+		char buffer[ 1024 ] {};
+		for ( int category = 0; category < static_cast< int >( memoryCategory_t::COUNT ); ++category ) {
+			if ( FormatCategoryStats( static_cast< memoryCategory_t >( category ), buffer, sizeof( buffer ) ) ) {
+				QP_DISCARD_RESULT fprintf( file, "%s\n", buffer );
+			}
+		}
+		QP_DISCARD_RESULT fclose( file );
+		return true;
+	}
+
+	void ReportLeaks() {
+		// statics that live for the whole program keep memory in most categories, so live allocations are only
+		// listed and tracked objects that are still alive are what counts as leaks.
+		for ( int category = 0; category < static_cast< int >( memoryCategory_t::COUNT ); ++category ) {
+			const memoryCategoryStats_t stats = GetStats( static_cast< memoryCategory_t >( category ) );
+			if ( stats.numLiveAllocations != 0 ) {
+				qpDebug::Info( "MemoryTracking: %s has %llu bytes in %llu allocations alive at exit.", CategoryName( static_cast< memoryCategory_t >( category ) ), stats.liveBytes, stats.numLiveAllocations );
+			}
+		}
+
+		bool hasLeaks = false;
+		trackedObjects_t & trackedObjects = GetTrackedObjects();
+		std::scoped_lock lock( trackedObjects.mutex );
+		for ( const trackedObject_t & trackedObject : trackedObjects.objects ) {
+			qpDebug::Warning( "MemoryTracking: %s \"%s\" is still alive.", CategoryName( trackedObject.category ), trackedObject.name );
+			hasLeaks = true;
+		}
+		if ( !hasLeaks ) {
+			qpDebug::Info( "MemoryTracking: No leaks." );
+		}
+	}
+}
+
+qpTrackedAllocator::qpTrackedAllocator( qpAllocator & backingAllocator ) : m_backingAllocator( &backingAllocator ), m_useCurrentCategory( true ) {
+}
+
+qpTrackedAllocator::qpTrackedAllocator( qpAllocator & backingAllocator, const memoryCategory_t category ) : m_backingAllocator( &backingAllocator ), m_category( category ) {
+}
+
+void * qpTrackedAllocator::Allocate( const uint64 size, const uint64 alignment ) {
+	const uint64 headerSize = AllocationHeaderSize( alignment );
+	byte * memory = static_cast< byte * >( m_backingAllocator->Allocate( headerSize + size, alignment ) );
+	if ( memory == NULL ) {
+		return NULL;
+	}
+	allocationHeader_t * header = new ( memory + headerSize - sizeof( allocationHeader_t ) ) allocationHeader_t();
+	header->size = size;
+	header->alignment = static_cast< uint32 >( alignment );
+	header->category = m_useCurrentCategory ? s_currentCategory : m_category;
+	qpMemoryTracking::OnAllocate( header->category, size );
+	return memory + headerSize;
+}
+
+void qpTrackedAllocator::Free( void * ptr, const uint64 size ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	const allocationHeader_t * header = reinterpret_cast< const allocationHeader_t * >( static_cast< byte * >( ptr ) - sizeof( allocationHeader_t ) );
+	QP_ASSERT_MSG( header->size == size, "Freeing memory with a different size than it was allocated with." );
+	const uint64 headerSize = AllocationHeaderSize( header->alignment );
+	const uint64 allocationSize = header->size;
+	qpMemoryTracking::OnFree( header->category, allocationSize );
+	m_backingAllocator->Free( static_cast< byte * >( ptr ) - headerSize, headerSize + allocationSize );
+}
+
+void * qpTrackedAllocator::Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment ) {
+	if ( ptr == NULL ) {
+		return Allocate( newSize, alignment );
+	}
+	const allocationHeader_t * header = reinterpret_cast< const allocationHeader_t * >( static_cast< byte * >( ptr ) - sizeof( allocationHeader_t ) );
+	QP_ASSERT_MSG( header->size == oldSize, "Reallocating memory with a different size than it was allocated with." );
+	if ( header->alignment != alignment ) {
+		// the header would move, so fall back to allocating and copying.
+		return qpAllocator::Reallocate( ptr, oldSize, newSize, alignment );
+	}
+	const uint64 headerSize = AllocationHeaderSize( alignment );
+	const memoryCategory_t category = header->category;
+	byte * memory = static_cast< byte * >( m_backingAllocator->Reallocate( static_cast< byte * >( ptr ) - headerSize, headerSize + oldSize, headerSize + newSize, alignment ) );
+	if ( memory == NULL ) {
+		return NULL;
+	}
+	allocationHeader_t * newHeader = reinterpret_cast< allocationHeader_t * >( memory + headerSize - sizeof( allocationHeader_t ) );
+	newHeader->size = newSize;
+	qpMemoryTracking::OnFree( category, oldSize );
+	qpMemoryTracking::OnAllocate( category, newSize );
+	return memory + headerSize;
+}
+
+qpAllocator & qpGetAllocator( const memoryCategory_t category ) {
+	static qpTrackedAllocator * categoryAllocators = [] () {
+		qpTrackedAllocator * allocators = static_cast< qpTrackedAllocator * >( ::operator new( sizeof( qpTrackedAllocator ) * static_cast< int >( memoryCategory_t::COUNT ) ) );
+		for ( int index = 0; index < static_cast< int >( memoryCategory_t::COUNT ); ++index ) {
+			new ( &allocators[ index ] ) qpTrackedAllocator( qpGetHeap(), static_cast< memoryCategory_t >( index ) );
+		}
+		return allocators;
+	}();
+	return categoryAllocators[ static_cast< int >( category ) ];
+}
+#else
+qpAllocator & qpGetAllocator( const memoryCategory_t ) {
+	return qpGetDefaultAllocator();
+}
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_types.h"
+
+#if !defined( QP_MEMORY_TRACKING )
+#if !defined( QP_RETAIL )
+#define QP_MEMORY_TRACKING
+#endif
+#endif
+
+enum class memoryCategory_t : uint8 {
+	GENERAL,
+	STRING,
+	RESOURCE,
+	RENDERER,
+	COUNT
+};
+
+enum : uint32 {
+	// allocation sizes are bucketed by powers of two, the first bucket is up to 16 bytes and the last one everything from 256 KiB.
+	MEMORY_SIZE_HISTOGRAM_BUCKETS = 16
+};
+
+struct memoryCategoryStats_t {
+	uint64 liveBytes = 0;
+	uint64 peakBytes = 0;
+	uint64 numLiveAllocations = 0;
+	uint64 numAllocations = 0;
+	uint64 sizeHistogram[ MEMORY_SIZE_HISTOGRAM_BUCKETS ] {};
+};
+
+// allocator that allocates through the default allocator for the category. with tracking compiled out
+// this is the default allocator for every category.
+qpAllocator & qpGetAllocator( const memoryCategory_t category );
+
+#if defined( QP_MEMORY_TRACKING )
+namespace qpMemoryTracking {
+	const char * CategoryName( const memoryCategory_t category );
+
+	void OnAllocate( const memoryCategory_t category, const uint64 size );
+	void OnFree( const memoryCategory_t category, const uint64 size );
+	memoryCategoryStats_t GetStats( const memoryCategory_t category );
+
+	// the category allocations through the default allocator are counted towards on this thread.
+	memoryCategory_t GetCurrentCategory();
+	void SetCurrentCategory( const memoryCategory_t category );
+
+	// named objects show up in the leak report if they haven't been untracked by then.
+	void TrackObject( const void * object, const memoryCategory_t category, const char * name );
+	void UntrackObject( const void * object );
+
+	// prints the stats of every category through qpDebug.
+	void DumpStats();
+	bool DumpStatsToFile( const char * filePath );
+	// lists the live allocations of every category and warns about every tracked object that is still alive.
+	void ReportLeaks();
+}
+
+// Counts every allocation towards a category. The category and size are stored in front of the allocation
+// so memory is counted correctly when it is freed from a different category scope.
+class qpTrackedAllocator : public qpAllocator {
+public:
+	// counts allocations towards the current category of the allocating thread.
+	explicit qpTrackedAllocator( qpAllocator & backingAllocator );
+	qpTrackedAllocator( qpAllocator & backingAllocator, const memoryCategory_t category );
+
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) override;
+	virtual void Free( void * ptr, const uint64 size ) override;
+	// the allocation stays counted towards the category it was allocated in.
+	virtual void * Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment = alignof( std::max_align_t ) ) override;
+private:
+	qpAllocator * m_backingAllocator = NULL;
+	memoryCategory_t m_category = memoryCategory_t::GENERAL;
+	bool m_useCurrentCategory = false;
+};
+
+// counts allocations made through the default allocator on this thread towards category while in scope.
+class qpMemoryCategoryScope {
+public:
+	explicit qpMemoryCategoryScope( const memoryCategory_t category ) : m_previousCategory( qpMemoryTracking::GetCurrentCategory() ) { qpMemoryTracking::SetCurrentCategory( category ); }
+	~qpMemoryCategoryScope() { qpMemoryTracking::SetCurrentCategory( m_previousCategory ); }
+
+	qpMemoryCategoryScope( const qpMemoryCategoryScope & other ) = delete;
+	qpMemoryCategoryScope & operator=( const qpMemoryCategoryScope & other ) = delete;
+private:
+	memoryCategory_t m_previousCategory;
+};
+#else
+namespace qpMemoryTracking {
+	inline void TrackObject( const void *, const memoryCategory_t, const char * ) {}
+	inline void UntrackObject( const void * ) {}
+	inline void DumpStats() {}
+	inline bool DumpStatsToFile( const char * ) { return false; }
+	inline void ReportLeaks() {}
+}
+
+class qpMemoryCategoryScope {
+public:
+	explicit qpMemoryCategoryScope( const memoryCategory_t ) {}
+};
+#endif
@@ -0,0 +1,184 @@
+#include "engine.pch.h"
+#include "qp_pool_allocator.h"
+#include "qp/common/math/qp_math.h"
+#include <bit>
+
+namespace {
+	uint32 FreeListIndex( const uint64 head ) { return static_cast< uint32 >( head & 0xFFFFFFFF ); }
+	uint64 FreeListHead( const uint64 oldHead, const uint32 index ) { return ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | index; }
+
+	// blocks have to be able to hold the free list link.
+	uint64 PoolBlockSize( const uint64 blockSize, const uint64 blockAlignment ) {
+		return qpAllocationUtil::AlignUp( qpMath::Max( blockSize, static_cast< uint64 >( sizeof( void * ) ) ), blockAlignment );
+	}
+}
+
+qpPoolAllocator::qpPoolAllocator( const uint64 blockSize, const uint64 blockAlignment, const uint64 blocksPerChunk, qpAllocator & chunkAllocator )
+	: m_blockAlignment( qpMath::Max( blockAlignment, static_cast< uint64 >( alignof( freeBlock_t ) ) ) ), m_blocksPerChunk( blocksPerChunk ), m_chunkAllocator( &chunkAllocator ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( blockAlignment ), "Alignment has to be a power of two." );
+	QP_ASSERT_MSG( blocksPerChunk > 0, "Chunks need room for at least one block." );
+	m_blockSize = PoolBlockSize( blockSize, m_blockAlignment );
+}
+
+qpPoolAllocator::~qpPoolAllocator() {
+	QP_ASSERT_MSG( m_numAllocatedBlocks == 0, "Pool allocator destroyed while blocks are still in use." );
+	while ( m_chunks != NULL ) {
+		chunk_t * next = m_chunks->next;
+		m_chunkAllocator->Free( m_chunks, ChunkSize() );
+		m_chunks = next;
+	}
+}
+
+void * qpPoolAllocator::Allocate() {
+	if ( m_freeList == NULL ) {
+		AllocateChunk();
+	}
+	freeBlock_t * block = m_freeList;
+	m_freeList = block->next;
+	++m_numAllocatedBlocks;
+	return block;
+}
+
+void qpPoolAllocator::Free( void * ptr ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	QP_ASSERT_MSG( m_numAllocatedBlocks > 0, "Freeing more blocks than were allocated." );
+	freeBlock_t * block = new ( ptr ) freeBlock_t();
+	block->next = m_freeList;
+	m_freeList = block;
+	--m_numAllocatedBlocks;
+}
+
+uint64 qpPoolAllocator::ChunkSize() const {
+	// the chunk header takes up the space of as many blocks as it needs so the blocks after it stay aligned.
+	return qpAllocationUtil::AlignUp( sizeof( chunk_t ), m_blockAlignment ) + m_blockSize * m_blocksPerChunk;
+}
+
+void qpPoolAllocator::AllocateChunk() {
+	const uint64 headerSize = qpAllocationUtil::AlignUp( sizeof( chunk_t ), m_blockAlignment );
+	byte * memory = static_cast< byte * >( m_chunkAllocator->Allocate( ChunkSize(), m_blockAlignment ) );
+	if ( memory == NULL ) {
+		throw std::bad_alloc();
+	}
+	chunk_t * chunk = new ( memory ) chunk_t();
+	chunk->next = m_chunks;
+	m_chunks = chunk;
+	++m_numChunks;
+
+	// pushed back to front so blocks are handed out in address order.
+	byte * blocks = memory + headerSize;
+	for ( uint64 index = m_blocksPerChunk; index > 0; --index ) {
+		freeBlock_t * block = new ( blocks + ( index - 1 ) * m_blockSize ) freeBlock_t();
+		block->next = m_freeList;
+		m_freeList = block;
+	}
+}
+
+qpConcurrentPoolAllocator::qpConcurrentPoolAllocator( const uint64 blockSize, const uint64 blockAlignment, const uint32 blocksPerChunk )
+	: m_blockAlignment( qpMath::Max( blockAlignment, static_cast< uint64 >( alignof( atomicUInt32_t ) ) ) ), m_blocksPerChunk( blocksPerChunk ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( blockAlignment ), "Alignment has to be a power of two." );
+	QP_ASSERT_MSG( blocksPerChunk > 0, "Chunks need room for at least one block." );
+	m_blockSize = PoolBlockSize( blockSize, m_blockAlignment );
+	// chunks are rounded up to a power of two so they can be aligned to their size, the extra room holds more blocks.
+	m_chunkHeaderSize = qpAllocationUtil::AlignUp( sizeof( chunkHeader_t ), m_blockAlignment );
+	m_chunkSize = std::bit_ceil( m_chunkHeaderSize + m_blockSize * blocksPerChunk );
+	m_blocksPerChunk = static_cast< uint32 >( ( m_chunkSize - m_chunkHeaderSize ) / m_blockSize );
+}
+
+qpConcurrentPoolAllocator::~qpConcurrentPoolAllocator() {
+	QP_ASSERT_MSG( m_numAllocatedBlocks.load() == 0, "Pool allocator destroyed while blocks are still in use." );
+	const uint32 numChunks = m_numChunks.load();
+	for ( uint32 index = 0; index < numChunks; ++index ) {
+		::operator delete( m_chunks[ index ].load(), std::align_val_t( m_chunkSize ) );
+	}
+}
+
+void * qpConcurrentPoolAllocator::Allocate() {
+	while ( true ) {
+		uint64 head = m_freeListHead.load( std::memory_order_acquire );
+		while ( FreeListIndex( head ) != INVALID_BLOCK_INDEX ) {
+			const uint32 index = FreeListIndex( head );
+			// the block could be handed out by another thread before this read, chunks are never released
+			// so the read is safe and the tag makes the swap fail if that happened.
+			const uint32 next = NextFreeBlock( index ).load( std::memory_order_relaxed );
+			if ( m_freeListHead.compare_exchange_weak( head, FreeListHead( head, next ), std::memory_order_acquire, std::memory_order_acquire ) ) {
+				m_numAllocatedBlocks.fetch_add( 1, std::memory_order_relaxed );
+				return GetBlock( index );
+			}
+		}
+		if ( !Grow() ) {
+			return NULL;
+		}
+	}
+}
+
+void qpConcurrentPoolAllocator::Free( void * ptr ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	const uint32 index = GetBlockIndex( ptr );
+	if ( !QP_VERIFY_RELEASE_MSG( index != INVALID_BLOCK_INDEX, "Freeing a block that doesn't belong to this pool." ) ) {
+		return;
+	}
+	new ( ptr ) atomicUInt32_t( INVALID_BLOCK_INDEX );
+	PushFreeBlocks( index, index );
+	m_numAllocatedBlocks.fetch_sub( 1, std::memory_order_relaxed );
+}
+
+byte * qpConcurrentPoolAllocator::GetBlock( const uint32 index ) const {
+	return m_chunks[ index / m_blocksPerChunk ].load( std::memory_order_acquire ) + m_chunkHeaderSize + static_cast< uint64 >( index % m_blocksPerChunk ) * m_blockSize;
+}
+
+uint32 qpConcurrentPoolAllocator::GetBlockIndex( const void * ptr ) const {
+	const byte * block = static_cast< const byte * >( ptr );
+	const byte * chunk = reinterpret_cast< const byte * >( reinterpret_cast< uintptr_t >( block ) & ~( m_chunkSize - 1 ) );
+	// the header is only trusted once the chunk it names turns out to be this one.
+	const uint32 chunkIndex = reinterpret_cast< const chunkHeader_t * >( chunk )->index;
+	if ( ( chunkIndex >= m_numChunks.load( std::memory_order_acquire ) ) || ( m_chunks[ chunkIndex ].load( std::memory_order_relaxed ) != chunk ) ) {
+		return INVALID_BLOCK_INDEX;
+	}
+	if ( block < chunk + m_chunkHeaderSize ) {
+		return INVALID_BLOCK_INDEX;
+	}
+	const uint64 blockIndex = static_cast< uint64 >( block - chunk - m_chunkHeaderSize ) / m_blockSize;
+	if ( blockIndex >= m_blocksPerChunk ) {
+		return INVALID_BLOCK_INDEX;
+	}
+	return chunkIndex * m_blocksPerChunk + static_cast< uint32 >( blockIndex );
+}
+
+void qpConcurrentPoolAllocator::PushFreeBlocks( const uint32 first, const uint32 last ) {
+	uint64 head = m_freeListHead.load( std::memory_order_relaxed );
+	do {
+		NextFreeBlock( last ).store( FreeListIndex( head ), std::memory_order_relaxed );
+	} while ( !m_freeListHead.compare_exchange_weak( head, FreeListHead( head, first ), std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+bool qpConcurrentPoolAllocator::Grow() {
+	std::scoped_lock lock( m_growMutex );
+	// another thread could have grown the pool while we waited for the lock.
+	if ( FreeListIndex( m_freeListHead.load( std::memory_order_acquire ) ) != INVALID_BLOCK_INDEX ) {
+		return true;
+	}
+	const uint32 chunkIndex = m_numChunks.load( std::memory_order_relaxed );
+	if ( ( chunkIndex >= MAX_CHUNKS ) || ( static_cast< uint64 >( chunkIndex + 1 ) * m_blocksPerChunk >= INVALID_BLOCK_INDEX ) ) {
+		qpDebug::Error( "ConcurrentPoolAllocator: Out of chunks for blocks of %llu bytes.", m_blockSize );
+		return false;
+	}
+
+	byte * chunk = static_cast< byte * >( ::operator new( m_chunkSize, std::align_val_t( m_chunkSize ) ) );
+	new ( chunk ) chunkHeader_t { chunkIndex };
+	m_chunks[ chunkIndex ].store( chunk, std::memory_order_release );
+	m_numChunks.store( chunkIndex + 1, std::memory_order_release );
+
+	// link the new blocks together and publish them with a single swap.
+	const uint32 first = chunkIndex * m_blocksPerChunk;
+	const uint32 last = first + m_blocksPerChunk - 1;
+	for ( uint32 index = first; index < last; ++index ) {
+		new ( GetBlock( index ) ) atomicUInt32_t( index + 1 );
+	}
+	new ( GetBlock( last ) ) atomicUInt32_t( INVALID_BLOCK_INDEX );
+	PushFreeBlocks( first, last );
+	return true;
+}
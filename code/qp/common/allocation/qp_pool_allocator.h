@@ -0,0 +1,121 @@
+#pragma once
+#include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+// Hands out fixed size blocks from chunks of memory that are allocated as needed and kept until the pool dies.
+// Freed blocks go on an intrusive free list so allocating and freeing is a couple of pointer swaps.
+// Not thread safe, see qpConcurrentPoolAllocator for that.
+class qpPoolAllocator {
+public:
+	// chunks are allocated through chunkAllocator, which has to outlive the pool.
+	qpPoolAllocator( const uint64 blockSize, const uint64 blockAlignment = alignof( std::max_align_t ), const uint64 blocksPerChunk = 64, qpAllocator & chunkAllocator = qpGetDefaultAllocator() );
+	~qpPoolAllocator();
+
+	qpPoolAllocator( const qpPoolAllocator & other ) = delete;
+	qpPoolAllocator & operator=( const qpPoolAllocator & other ) = delete;
+
+	void * Allocate();
+	void Free( void * ptr );
+
+	uint64 BlockSize() const { return m_blockSize; }
+	uint64 NumAllocatedBlocks() const { return m_numAllocatedBlocks; }
+	uint64 NumChunks() const { return m_numChunks; }
+private:
+	struct freeBlock_t {
+		freeBlock_t * next = NULL;
+	};
+	struct chunk_t {
+		chunk_t * next = NULL;
+	};
+	uint64 m_blockSize = 0;
+	uint64 m_blockAlignment = 0;
+	uint64 m_blocksPerChunk = 0;
+	freeBlock_t * m_freeList = NULL;
+	chunk_t * m_chunks = NULL;
+	uint64 m_numChunks = 0;
+	uint64 m_numAllocatedBlocks = 0;
+	qpAllocator * m_chunkAllocator = NULL;
+
+	uint64 ChunkSize() const;
+	void AllocateChunk();
+};
+
+// Thread safe pool, blocks can be allocated and freed from any thread.
+// The free list is lock free, blocks are referred to by index so the head can carry a tag that's bumped on every
+// change, otherwise a block that is popped and pushed back between another thread's load and swap would corrupt the list.
+// Only growing takes a lock. Chunks are aligned to their size so freeing finds a block's chunk by masking the pointer.
+class qpConcurrentPoolAllocator {
+public:
+	enum : uint32 {
+		MAX_CHUNKS = 1024
+	};
+
+	qpConcurrentPoolAllocator( const uint64 blockSize, const uint64 blockAlignment = alignof( std::max_align_t ), const uint32 blocksPerChunk = 64 );
+	~qpConcurrentPoolAllocator();
+
+	qpConcurrentPoolAllocator( const qpConcurrentPoolAllocator & other ) = delete;
+	qpConcurrentPoolAllocator & operator=( const qpConcurrentPoolAllocator & other ) = delete;
+
+	// returns NULL if every chunk is in use and there is no room for another one.
+	void * Allocate();
+	void Free( void * ptr );
+
+	uint64 BlockSize() const { return m_blockSize; }
+	uint64 NumAllocatedBlocks() const { return m_numAllocatedBlocks.load( std::memory_order_relaxed ); }
+private:
+	enum : uint32 {
+		INVALID_BLOCK_INDEX = 0xFFFFFFFF
+	};
+	struct chunkHeader_t {
+		uint32 index = 0;
+	};
+	uint64 m_blockSize = 0;
+	uint64 m_blockAlignment = 0;
+	uint64 m_chunkSize = 0;
+	uint64 m_chunkHeaderSize = 0;
+	uint32 m_blocksPerChunk = 0;
+	atomic_t< byte * > m_chunks[ MAX_CHUNKS ] {};
+	atomicUInt32_t m_numChunks = 0;
+	std::mutex m_growMutex;
+	alignas( 64 ) atomicUInt64_t m_freeListHead = INVALID_BLOCK_INDEX;
+	alignas( 64 ) atomicUInt64_t m_numAllocatedBlocks = 0;
+
+	byte * GetBlock( const uint32 index ) const;
+	// returns INVALID_BLOCK_INDEX if the block doesn't belong to this pool.
+	uint32 GetBlockIndex( const void * ptr ) const;
+	atomicUInt32_t & NextFreeBlock( const uint32 index ) const { return *reinterpret_cast< atomicUInt32_t * >( GetBlock( index ) ); }
+	void PushFreeBlocks( const uint32 first, const uint32 last );
+	bool Grow();
+};
+
+// constructs and destroys _type_s in blocks from a pool allocator.
+template < typename _type_, typename _allocator_ = qpPoolAllocator >
+class qpTypedPoolAllocator {
+public:
+	explicit qpTypedPoolAllocator( const uint32 blocksPerChunk = 64 ) : m_allocator( sizeof( _type_ ), alignof( _type_ ), blocksPerChunk ) {}
+
+	template < typename ... _args_ >
+	_type_ * New( _args_ &&... args ) {
+		void * memory = m_allocator.Allocate();
+		if ( memory == NULL ) {
+			return NULL;
+		}
+		return new ( memory ) _type_( qpForward< _args_ >( args )... );
+	}
+	void Delete( _type_ * ptr ) {
+		if ( ptr != NULL ) {
+			ptr->~_type_();
+			m_allocator.Free( ptr );
+		}
+	}
+
+	uint64 NumAllocated() const { return m_allocator.NumAllocatedBlocks(); }
+private:
+	_allocator_ m_allocator;
+};
@@ -0,0 +1,85 @@
+#include "engine.pch.h"
+#include "qp_scratch_allocator.h"
+#include "qp_allocation_util.h"
+#include "qp/common/math/qp_math.h"
+
+namespace {
+	// memory is committed in steps of at least this many bytes so growing the arena doesn't hit the os for every allocation.
+	const uint64 s_minCommitSize = 64 * 1024;
+}
+
+qpScratchAllocator::~qpScratchAllocator() {
+	if ( m_memory != NULL ) {
+		Sys_ReleaseMemory( m_memory, RESERVED_SIZE );
+	}
+}
+
+void * qpScratchAllocator::Allocate( const uint64 size, const uint64 alignment ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( alignment ) && ( alignment <= Sys_PageSize() ), "Alignment has to be a power of two no bigger than the page size." );
+	if ( m_memory == NULL ) {
+		// reserved on first use so threads that never use scratch memory don't pay for it.
+		m_memory = static_cast< byte * >( Sys_ReserveMemory( RESERVED_SIZE ) );
+		if ( m_memory == NULL ) {
+			return qpGetDefaultAllocator().Allocate( size, alignment );
+		}
+	}
+	// the arena starts on a page so aligning the offset aligns the pointer.
+	const uint64 offset = qpAllocationUtil::AlignUp( m_bytesAllocated, alignment );
+	if ( ( offset > RESERVED_SIZE ) || ( size > RESERVED_SIZE - offset ) ) {
+		return qpGetDefaultAllocator().Allocate( size, alignment );
+	}
+	const uint64 end = offset + size;
+	if ( !CommitTo( end ) ) {
+		return qpGetDefaultAllocator().Allocate( size, alignment );
+	}
+	m_bytesAllocated = end;
+	m_peakBytesAllocated = qpMath::Max( m_peakBytesAllocated, m_bytesAllocated );
+	return m_memory + offset;
+}
+
+void qpScratchAllocator::Free( void * ptr, const uint64 size ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	if ( !Owns( ptr ) ) {
+		qpGetDefaultAllocator().Free( ptr, size );
+		return;
+	}
+	if ( static_cast< byte * >( ptr ) + size == m_memory + m_bytesAllocated ) {
+		m_bytesAllocated -= size;
+	}
+}
+
+void * qpScratchAllocator::Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment ) {
+	if ( ( ptr != NULL ) && Owns( ptr ) && ( static_cast< byte * >( ptr ) + oldSize == m_memory + m_bytesAllocated ) ) {
+		const uint64 offset = static_cast< uint64 >( static_cast< byte * >( ptr ) - m_memory );
+		if ( ( newSize <= RESERVED_SIZE - offset ) && CommitTo( offset + newSize ) ) {
+			m_bytesAllocated = offset + newSize;
+			m_peakBytesAllocated = qpMath::Max( m_peakBytesAllocated, m_bytesAllocated );
+			return ptr;
+		}
+	}
+	return qpAllocator::Reallocate( ptr, oldSize, newSize, alignment );
+}
+
+void qpScratchAllocator::RewindToCheckpoint( const checkpoint_t checkpoint ) {
+	QP_ASSERT_MSG( checkpoint.offset <= m_bytesAllocated, "Rewinding to a checkpoint that has already been rewound past." );
+	m_bytesAllocated = qpMath::Min( checkpoint.offset, m_bytesAllocated );
+}
+
+bool qpScratchAllocator::CommitTo( const uint64 end ) {
+	if ( end <= m_bytesCommitted ) {
+		return true;
+	}
+	const uint64 commitEnd = qpMath::Min( qpMath::Max( qpAllocationUtil::AlignUp( end, Sys_PageSize() ), m_bytesCommitted + s_minCommitSize ), static_cast< uint64 >( RESERVED_SIZE ) );
+	if ( !Sys_CommitMemory( m_memory + m_bytesCommitted, commitEnd - m_bytesCommitted ) ) {
+		return false;
+	}
+	m_bytesCommitted = commitEnd;
+	return true;
+}
+
+qpScratchAllocator & qpGetScratchAllocator() {
+	thread_local qpScratchAllocator scratchAllocator;
+	return scratchAllocator;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_types.h"
+
+// Per thread arena for temporaries such as formatted strings, paths and file buffers that are parsed and thrown away.
+// Allocating is a pointer bump into memory that stays committed, so once the arena has grown to the working size of
+// the thread nothing that only uses scratch memory touches the heap. Memory is given back by rewinding to a checkpoint,
+// put a qpScratchScope around the work and don't let anything allocated inside it outlive the scope.
+// Allocations that don't fit in the reserved address space fall back to the default allocator and are freed with Free.
+class qpScratchAllocator : public qpAllocator {
+public:
+	enum : uint64 {
+		// address space reserved per thread, memory is only committed as the arena grows into it.
+		RESERVED_SIZE = 64 * 1024 * 1024
+	};
+
+	struct checkpoint_t {
+		uint64 offset = 0;
+	};
+
+	qpScratchAllocator() = default;
+	virtual ~qpScratchAllocator() override;
+
+	qpScratchAllocator( const qpScratchAllocator & other ) = delete;
+	qpScratchAllocator & operator=( const qpScratchAllocator & other ) = delete;
+
+	virtual void * Allocate( const uint64 size, const uint64 alignment = alignof( std::max_align_t ) ) override;
+	// individual allocations aren't freed, except the most recent one which is just rolled back.
+	virtual void Free( void * ptr, const uint64 size ) override;
+	// the most recent allocation grows and shrinks in place.
+	virtual void * Reallocate( void * ptr, const uint64 oldSize, const uint64 newSize, const uint64 alignment = alignof( std::max_align_t ) ) override;
+
+	checkpoint_t GetCheckpoint() const { return checkpoint_t { m_bytesAllocated }; }
+	// frees everything allocated in the arena after the checkpoint was taken.
+	void RewindToCheckpoint( const checkpoint_t checkpoint );
+
+	bool Owns( const void * ptr ) const { return ( m_memory != NULL ) && ( ptr >= m_memory ) && ( ptr < m_memory + RESERVED_SIZE ); }
+	uint64 BytesAllocated() const { return m_bytesAllocated; }
+	uint64 BytesCommitted() const { return m_bytesCommitted; }
+	uint64 PeakBytesAllocated() const { return m_peakBytesAllocated; }
+private:
+	byte * m_memory = NULL;
+	uint64 m_bytesAllocated = 0;
+	uint64 m_bytesCommitted = 0;
+	uint64 m_peakBytesAllocated = 0;
+
+	bool CommitTo( const uint64 end );
+};
+
+// the scratch arena of the calling thread.
+qpScratchAllocator & qpGetScratchAllocator();
+
+// rewinds the scratch arena of the calling thread to where it was when the scope was entered.
+class qpScratchScope {
+public:
+	qpScratchScope() : m_allocator( qpGetScratchAllocator() ), m_checkpoint( m_allocator.GetCheckpoint() ) {}
+	~qpScratchScope() { m_allocator.RewindToCheckpoint( m_checkpoint ); }
+
+	qpScratchScope( const qpScratchScope & other ) = delete;
+	qpScratchScope & operator=( const qpScratchScope & other ) = delete;
+
+	qpScratchAllocator & GetAllocator() const { return m_allocator; }
+private:
+	qpScratchAllocator & m_allocator;
+	qpScratchAllocator::checkpoint_t m_checkpoint;
+};
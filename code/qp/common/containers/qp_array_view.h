@@ -8,6 +8,9 @@ class qpList;
 template < typename _type_, int _size_ >
 class qpStaticList;
 
+template < typename _type_, int _inlineCapacity_ >
+class qpSmallList;
+
 template < typename _type_, int _size_ >
 class qpArray;
 
@@ -41,11 +44,14 @@ public:
 	private:
 		pointer m_ptr = NULL;
 	};
+	qpArrayView( const _type_ * data, const int length ) : m_length( length ), m_ptr( data ) {}
 	qpArrayView( const qpList< _type_ > & list );
 	template < int _size_ >
 	explicit qpArrayView( const qpStaticList< _type_, _size_ > & list );
 	template < int _size_ >
 	qpArrayView( const qpArray< _type_, _size_ > & arr );
+	template < int _inlineCapacity_ >
+	qpArrayView( const qpSmallList< _type_, _inlineCapacity_ > & list );
 
 	int Length() const { return m_length; }
 	const _type_ * Data() const { return m_ptr; }
@@ -78,3 +84,10 @@ qpArrayView<_type_>::qpArrayView( const qpArray< _type_, _size_ > & arr ) {
 	m_ptr = &arr.m_data[ 0 ];
 	m_length = arr.Length();
 }
+
+template< typename _type_ >
+template< int _inlineCapacity_ >
+qpArrayView< _type_ >::qpArrayView( const qpSmallList< _type_, _inlineCapacity_ > & list ) {
+	m_ptr = list.m_data;
+	m_length = static_cast< int >( list.Length() );
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "qp_flat_table.h"
+#include <type_traits>
+
+template < typename _key_, typename _value_ >
+struct flatMapEntry_t {
+	_key_ key;
+	_value_ value;
+
+	// not explicit so maps can be built from { { key, value }, ... }.
+	template < typename _keyArg_, typename _valueArg_ >
+	flatMapEntry_t( _keyArg_ && keyArg, _valueArg_ && valueArg ) : key( qpForward< _keyArg_ >( keyArg ) ), value( qpForward< _valueArg_ >( valueArg ) ) {}
+	template < typename _keyArg_, typename ... _args_ > requires ( ( sizeof...( _args_ ) != 1 ) && !std::is_same_v< std::remove_cvref_t< _keyArg_ >, flatMapEntry_t > )
+	explicit flatMapEntry_t( _keyArg_ && keyArg, _args_ &&... args ) : key( qpForward< _keyArg_ >( keyArg ) ), value( qpForward< _args_ >( args )... ) {}
+
+	static const _key_ & KeyOf( const flatMapEntry_t & entry ) { return entry.key; }
+};
+
+// Map stored as a sorted array, see qpFlatTable. Iterating gives the entries with their key and value in key order.
+// Don't change the key of an entry, it would break the order.
+template < typename _key_, typename _value_, typename _less_ = qpLess< _key_ > >
+class qpFlatMap : public qpFlatTable< _key_, flatMapEntry_t< _key_, _value_ >, flatMapEntry_t< _key_, _value_ >, _less_ > {
+	using table_t = qpFlatTable< _key_, flatMapEntry_t< _key_, _value_ >, flatMapEntry_t< _key_, _value_ >, _less_ >;
+public:
+	using entry_t = flatMapEntry_t< _key_, _value_ >;
+	using table_t::table_t;
+
+	// returns NULL if there is no value for the key.
+	template < typename _lookup_ >
+	_value_ * Find( const _lookup_ & key );
+	template < typename _lookup_ >
+	const _value_ * Find( const _lookup_ & key ) const;
+
+	// inserts the value or replaces the one the key already has.
+	template < typename _keyArg_, typename _valueArg_ >
+	_value_ & Insert( _keyArg_ && key, _valueArg_ && value );
+	// constructs the value from args if the key doesn't have one yet, otherwise returns the value it has.
+	template < typename _keyArg_, typename ... _args_ >
+	_value_ & Emplace( _keyArg_ && key, _args_ &&... args );
+
+	// default constructs the value if the key doesn't have one yet.
+	template < typename _keyArg_ >
+	_value_ & operator[]( _keyArg_ && key ) { return Emplace( qpForward< _keyArg_ >( key ) ); }
+};
+
+template < typename _key_, typename _value_, typename _less_ >
+template < typename _lookup_ >
+_value_ * qpFlatMap< _key_, _value_, _less_ >::Find( const _lookup_ & key ) {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? &this->EntryAt( index )->value : NULL;
+}
+
+template < typename _key_, typename _value_, typename _less_ >
+template < typename _lookup_ >
+const _value_ * qpFlatMap< _key_, _value_, _less_ >::Find( const _lookup_ & key ) const {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? &this->EntryAt( index )->value : NULL;
+}
+
+template < typename _key_, typename _value_, typename _less_ >
+template < typename _keyArg_, typename _valueArg_ >
+_value_ & qpFlatMap< _key_, _value_, _less_ >::Insert( _keyArg_ && key, _valueArg_ && value ) {
+	bool inserted = false;
+	entry_t * entry = this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ), qpForward< _valueArg_ >( value ) );
+	if ( !inserted ) {
+		entry->value = qpForward< _valueArg_ >( value );
+	}
+	return entry->value;
+}
+
+template < typename _key_, typename _value_, typename _less_ >
+template < typename _keyArg_, typename ... _args_ >
+_value_ & qpFlatMap< _key_, _value_, _less_ >::Emplace( _keyArg_ && key, _args_ &&... args ) {
+	bool inserted = false;
+	return this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ), qpForward< _args_ >( args )... )->value;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "qp_flat_table.h"
+
+template < typename _key_ >
+struct flatSetKeyOf_t {
+	static const _key_ & KeyOf( const _key_ & key ) { return key; }
+};
+
+// Set stored as a sorted array, see qpFlatTable. Iterating gives the keys in order.
+// Don't change a key through an iterator, it would break the order.
+template < typename _key_, typename _less_ = qpLess< _key_ > >
+class qpFlatSet : public qpFlatTable< _key_, _key_, flatSetKeyOf_t< _key_ >, _less_ > {
+	using table_t = qpFlatTable< _key_, _key_, flatSetKeyOf_t< _key_ >, _less_ >;
+public:
+	using table_t::table_t;
+
+	// returns false if the key was already in the set.
+	template < typename _keyArg_ >
+	bool Insert( _keyArg_ && key );
+
+	// returns NULL if the key isn't in the set.
+	template < typename _lookup_ >
+	const _key_ * Find( const _lookup_ & key ) const;
+};
+
+template < typename _key_, typename _less_ >
+template < typename _keyArg_ >
+bool qpFlatSet< _key_, _less_ >::Insert( _keyArg_ && key ) {
+	bool inserted = false;
+	QP_DISCARD_RESULT this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ) );
+	return inserted;
+}
+
+template < typename _key_, typename _less_ >
+template < typename _lookup_ >
+const _key_ * qpFlatSet< _key_, _less_ >::Find( const _lookup_ & key ) const {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? this->EntryAt( index ) : NULL;
+}
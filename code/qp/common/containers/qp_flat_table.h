@@ -0,0 +1,181 @@
+#pragma once
+#include "qp_array_view.h"
+#include "qp_list.h"
+#include "qp/common/utilities/qp_algorithms.h"
+#include "qp/common/utilities/qp_initializer_list.h"
+
+// Sorted array that qpFlatSet and qpFlatMap are built on.
+// The entries are stored in key order in a single qpList, so a lookup is a binary search over contiguous memory and
+// iterating walks the list, instead of following a pointer per node like qpSet does. Inserting and removing move the
+// entries after them, so it suits data that is mostly read. Build big tables in bulk, which sorts once, instead of
+// inserting one entry at a time.
+// Lookups take any type _less_ can compare with the keys, e.g. a c string for string keys.
+// Inserting or removing moves entries, so pointers to entries are only valid until the table is modified.
+// _keyOf_ has to have a static KeyOf( const _entry_ & ) returning the key of an entry.
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+class qpFlatTable {
+public:
+	QP_FORWARD_ITERATOR( Iterator, qpFlatTable, _entry_ )
+
+	qpFlatTable() = default;
+	// the table allocates its entries through allocator, which has to outlive the table.
+	explicit qpFlatTable( qpAllocator & allocator ) : m_entries( allocator ) {}
+	// the bulk constructors sort the entries once, if several entries have the same key only one of them is kept.
+	qpFlatTable( qpInitializerList< _entry_ > initializerList );
+	qpFlatTable( const _entry_ * begin, const _entry_ * end );
+	explicit qpFlatTable( qpList< _entry_ > && entries );
+
+	template < typename _lookup_ >
+	bool Contains( const _lookup_ & key ) const { return FindIndex( key ) != INVALID_INDEX; }
+	// returns false if there was no entry with the key.
+	template < typename _lookup_ >
+	bool Remove( const _lookup_ & key );
+
+	// first entry whose key isn't less than key.
+	template < typename _lookup_ >
+	Iterator LowerBound( const _lookup_ & key ) const { return Iterator( EntryAt( LowerBoundIndex( key ) ) ); }
+	// first entry whose key is greater than key.
+	template < typename _lookup_ >
+	Iterator UpperBound( const _lookup_ & key ) const { return Iterator( EntryAt( UpperBoundIndex( key ) ) ); }
+	// entries with min <= key < max in key order.
+	template < typename _lookup_ >
+	qpArrayView< _entry_ > Range( const _lookup_ & min, const _lookup_ & max ) const;
+
+	void Reserve( const uint64 numEntries ) { m_entries.Reserve( numEntries ); }
+	void ShrinkToFit() { m_entries.ShrinkToFit(); }
+	void Clear() { m_entries.Clear(); }
+
+	uint64 Length() const { return m_entries.Length(); }
+	uint64 Capacity() const { return m_entries.Capacity(); }
+	bool IsEmpty() const { return m_entries.IsEmpty(); }
+	const _entry_ * Data() const { return m_entries.Data(); }
+
+	qpAllocator & GetAllocator() const { return m_entries.GetAllocator(); }
+
+	QP_ITERATORS( Iterator, Iterator( EntryAt( 0 ) ), Iterator( EntryAt( m_entries.Length() ) ) )
+protected:
+	enum : uint64 {
+		INVALID_INDEX = ~0ull
+	};
+
+	template < typename _lookup_ >
+	uint64 FindIndex( const _lookup_ & key ) const;
+	// constructs the entry from args if there isn't one with the key, returns the entry and whether it was inserted.
+	template < typename _lookup_, typename ... _args_ >
+	_entry_ * FindOrEmplace( const _lookup_ & key, bool & outInserted, _args_ &&... args );
+
+	_entry_ * EntryAt( const uint64 index ) const { return m_entries.Data() + index; }
+private:
+	qpList< _entry_ > m_entries;
+
+	template < typename _lookup_ >
+	uint64 LowerBoundIndex( const _lookup_ & key ) const;
+	template < typename _lookup_ >
+	uint64 UpperBoundIndex( const _lookup_ & key ) const;
+	void SortAndRemoveDuplicates();
+};
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::qpFlatTable( qpInitializerList< _entry_ > initializerList ) : m_entries( initializerList ) {
+	SortAndRemoveDuplicates();
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::qpFlatTable( const _entry_ * begin, const _entry_ * end ) {
+	m_entries.Reserve( static_cast< uint64 >( end - begin ) );
+	for ( const _entry_ * entry = begin; entry != end; ++entry ) {
+		m_entries.Push( *entry );
+	}
+	SortAndRemoveDuplicates();
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::qpFlatTable( qpList< _entry_ > && entries ) : m_entries( qpMove( entries ) ) {
+	SortAndRemoveDuplicates();
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_ >
+bool qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::Remove( const _lookup_ & key ) {
+	const uint64 index = FindIndex( key );
+	if ( index == INVALID_INDEX ) {
+		return false;
+	}
+	m_entries.RemoveIndex( index );
+	return true;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_ >
+qpArrayView< _entry_ > qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::Range( const _lookup_ & min, const _lookup_ & max ) const {
+	const uint64 first = LowerBoundIndex( min );
+	const uint64 last = qpMath::Max( first, LowerBoundIndex( max ) );
+	return qpArrayView< _entry_ >( EntryAt( first ), static_cast< int >( last - first ) );
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_ >
+uint64 qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::FindIndex( const _lookup_ & key ) const {
+	const uint64 index = LowerBoundIndex( key );
+	if ( ( index == m_entries.Length() ) || _less_()( key, _keyOf_::KeyOf( *EntryAt( index ) ) ) ) {
+		return INVALID_INDEX;
+	}
+	return index;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_, typename ... _args_ >
+_entry_ * qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::FindOrEmplace( const _lookup_ & key, bool & outInserted, _args_ &&... args ) {
+	const uint64 index = LowerBoundIndex( key );
+	if ( ( index < m_entries.Length() ) && !_less_()( key, _keyOf_::KeyOf( *EntryAt( index ) ) ) ) {
+		outInserted = false;
+		return EntryAt( index );
+	}
+	outInserted = true;
+	return &m_entries.EmplaceAt( index, qpForward< _args_ >( args )... );
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_ >
+uint64 qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::LowerBoundIndex( const _lookup_ & key ) const {
+	const _entry_ * entries = m_entries.Data();
+	const _entry_ * found = qpLowerBound( entries, entries + m_entries.Length(), key, []( const _entry_ & entry, const _lookup_ & lookup ) {
+		return _less_()( _keyOf_::KeyOf( entry ), lookup );
+	} );
+	return static_cast< uint64 >( found - entries );
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+template < typename _lookup_ >
+uint64 qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::UpperBoundIndex( const _lookup_ & key ) const {
+	const _entry_ * entries = m_entries.Data();
+	const _entry_ * found = qpUpperBound( entries, entries + m_entries.Length(), key, []( const _lookup_ & lookup, const _entry_ & entry ) {
+		return _less_()( lookup, _keyOf_::KeyOf( entry ) );
+	} );
+	return static_cast< uint64 >( found - entries );
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _less_ >
+void qpFlatTable< _key_, _entry_, _keyOf_, _less_ >::SortAndRemoveDuplicates() {
+	_entry_ * entries = m_entries.Data();
+	const uint64 length = m_entries.Length();
+	qpSort( entries, entries + length, []( const _entry_ & a, const _entry_ & b ) {
+		return _less_()( _keyOf_::KeyOf( a ), _keyOf_::KeyOf( b ) );
+	} );
+	if ( length < 2 ) {
+		return;
+	}
+	// the entries are sorted, so an entry is a duplicate if the last kept key isn't less than its key.
+	uint64 numUnique = 1;
+	for ( uint64 index = 1; index < length; ++index ) {
+		if ( _less_()( _keyOf_::KeyOf( entries[ numUnique - 1 ] ), _keyOf_::KeyOf( entries[ index ] ) ) ) {
+			if ( numUnique != index ) {
+				entries[ numUnique ] = qpMove( entries[ index ] );
+			}
+			++numUnique;
+		}
+	}
+	while ( m_entries.Length() > numUnique ) {
+		m_entries.Pop();
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "qp_hash_table.h"
+#include <type_traits>
+
+template < typename _key_, typename _value_ >
+struct hashMapEntry_t {
+	_key_ key;
+	_value_ value;
+
+	template < typename _keyArg_, typename ... _args_ > requires ( !std::is_same_v< std::remove_cvref_t< _keyArg_ >, hashMapEntry_t > )
+	explicit hashMapEntry_t( _keyArg_ && keyArg, _args_ &&... args ) : key( qpForward< _keyArg_ >( keyArg ) ), value( qpForward< _args_ >( args )... ) {}
+
+	static const _key_ & KeyOf( const hashMapEntry_t & entry ) { return entry.key; }
+};
+
+// Hash map with open addressing, see qpHashTable. Iterating gives the entries with their key and value, in no particular order.
+// Don't change the key of an entry while iterating.
+template < typename _key_, typename _value_, typename _hash_ = qpHash< _key_ >, typename _equal_ = qpEqual< _key_ > >
+class qpHashMap : public qpHashTable< _key_, hashMapEntry_t< _key_, _value_ >, hashMapEntry_t< _key_, _value_ >, _hash_, _equal_ > {
+	using table_t = qpHashTable< _key_, hashMapEntry_t< _key_, _value_ >, hashMapEntry_t< _key_, _value_ >, _hash_, _equal_ >;
+public:
+	using entry_t = hashMapEntry_t< _key_, _value_ >;
+	using table_t::table_t;
+
+	// returns NULL if there is no value for the key.
+	template < typename _lookup_ >
+	_value_ * Find( const _lookup_ & key );
+	template < typename _lookup_ >
+	const _value_ * Find( const _lookup_ & key ) const;
+
+	// inserts the value or replaces the one the key already has.
+	template < typename _keyArg_, typename _valueArg_ >
+	_value_ & Insert( _keyArg_ && key, _valueArg_ && value );
+	// constructs the value from args if the key doesn't have one yet, otherwise returns the value it has.
+	template < typename _keyArg_, typename ... _args_ >
+	_value_ & Emplace( _keyArg_ && key, _args_ &&... args );
+
+	// default constructs the value if the key doesn't have one yet.
+	template < typename _keyArg_ >
+	_value_ & operator[]( _keyArg_ && key ) { return Emplace( qpForward< _keyArg_ >( key ) ); }
+};
+
+template < typename _key_, typename _value_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+_value_ * qpHashMap< _key_, _value_, _hash_, _equal_ >::Find( const _lookup_ & key ) {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? &this->EntryAt( index )->value : NULL;
+}
+
+template < typename _key_, typename _value_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+const _value_ * qpHashMap< _key_, _value_, _hash_, _equal_ >::Find( const _lookup_ & key ) const {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? &this->EntryAt( index )->value : NULL;
+}
+
+template < typename _key_, typename _value_, typename _hash_, typename _equal_ >
+template < typename _keyArg_, typename _valueArg_ >
+_value_ & qpHashMap< _key_, _value_, _hash_, _equal_ >::Insert( _keyArg_ && key, _valueArg_ && value ) {
+	bool inserted = false;
+	entry_t * entry = this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ), qpForward< _valueArg_ >( value ) );
+	if ( !inserted ) {
+		entry->value = qpForward< _valueArg_ >( value );
+	}
+	return entry->value;
+}
+
+template < typename _key_, typename _value_, typename _hash_, typename _equal_ >
+template < typename _keyArg_, typename ... _args_ >
+_value_ & qpHashMap< _key_, _value_, _hash_, _equal_ >::Emplace( _keyArg_ && key, _args_ &&... args ) {
+	bool inserted = false;
+	return this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ), qpForward< _args_ >( args )... )->value;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "qp_hash_table.h"
+
+template < typename _key_ >
+struct hashSetKeyOf_t {
+	static const _key_ & KeyOf( const _key_ & key ) { return key; }
+};
+
+// Hash set with open addressing, see qpHashTable. Iterating gives the keys in no particular order.
+template < typename _key_, typename _hash_ = qpHash< _key_ >, typename _equal_ = qpEqual< _key_ > >
+class qpHashSet : public qpHashTable< _key_, _key_, hashSetKeyOf_t< _key_ >, _hash_, _equal_ > {
+	using table_t = qpHashTable< _key_, _key_, hashSetKeyOf_t< _key_ >, _hash_, _equal_ >;
+public:
+	using table_t::table_t;
+
+	// returns false if the key was already in the set.
+	template < typename _keyArg_ >
+	bool Insert( _keyArg_ && key );
+
+	// returns NULL if the key isn't in the set.
+	template < typename _lookup_ >
+	const _key_ * Find( const _lookup_ & key ) const;
+};
+
+template < typename _key_, typename _hash_, typename _equal_ >
+template < typename _keyArg_ >
+bool qpHashSet< _key_, _hash_, _equal_ >::Insert( _keyArg_ && key ) {
+	bool inserted = false;
+	QP_DISCARD_RESULT this->FindOrEmplace( key, inserted, qpForward< _keyArg_ >( key ) );
+	return inserted;
+}
+
+template < typename _key_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+const _key_ * qpHashSet< _key_, _hash_, _equal_ >::Find( const _lookup_ & key ) const {
+	const uint64 index = this->FindIndex( key );
+	return ( index != table_t::INVALID_INDEX ) ? this->EntryAt( index ) : NULL;
+}
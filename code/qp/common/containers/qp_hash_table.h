@@ -0,0 +1,329 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/math/qp_math.h"
+#include "qp/common/utilities/qp_hash.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <bit>
+#include <iterator>
+#include <new>
+
+// Open addressing hash table with robin hood probing that qpHashMap and qpHashSet are built on.
+// Every slot stores how far its entry is from the slot its hash points at. Inserting moves entries that are
+// closer to their slot out of the way, so probe lengths stay short and even, and lookups stop as soon as they
+// reach an entry that is closer to its slot than the key would be. Removing shifts the following entries back
+// instead of leaving tombstones.
+// Lookups take any type the hash and equality functors accept, e.g. a c string for string keys.
+// Inserting or removing moves entries, so pointers to entries are only valid until the table is modified.
+// _keyOf_ has to have a static KeyOf( const _entry_ & ) returning the key of an entry.
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+class qpHashTable {
+public:
+	struct Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = _entry_;
+		using pointer = _entry_ *;
+		using reference = _entry_ &;
+
+		Iterator( const qpHashTable * table, const uint64 index ) : m_table( table ), m_index( index ) { SkipEmpty(); }
+
+		reference operator *() const { return m_table->m_entries[ m_index ]; }
+		pointer operator->() const { return &m_table->m_entries[ m_index ]; }
+		Iterator & operator++() {
+			++m_index;
+			SkipEmpty();
+			return *this;
+		}
+		Iterator operator++( int ) {
+			Iterator it = *this;
+			++*this;
+			return it;
+		}
+
+		bool operator==( const Iterator & other ) const { return m_index == other.m_index; }
+	private:
+		const qpHashTable * m_table = NULL;
+		uint64 m_index = 0;
+
+		void SkipEmpty() {
+			while ( ( m_index < m_table->m_capacity ) && ( m_table->m_distances[ m_index ] == 0 ) ) {
+				++m_index;
+			}
+		}
+	};
+
+	qpHashTable() = default;
+	// the table allocates its entries through allocator, which has to outlive the table.
+	explicit qpHashTable( qpAllocator & allocator ) : m_allocator( &allocator ) {}
+	qpHashTable( const qpHashTable & other );
+	qpHashTable( qpHashTable && other ) noexcept;
+	~qpHashTable();
+
+	template < typename _lookup_ >
+	bool Contains( const _lookup_ & key ) const { return FindIndex( key ) != INVALID_INDEX; }
+	// returns false if there was no entry with the key.
+	template < typename _lookup_ >
+	bool Remove( const _lookup_ & key );
+
+	// makes room for numEntries without rehashing.
+	void Reserve( const uint64 numEntries );
+	// rebuilds the table with at least capacity slots, never fewer than the entries need.
+	void Rehash( const uint64 capacity );
+	void Clear();
+
+	uint64 Length() const { return m_length; }
+	uint64 Capacity() const { return m_capacity; }
+	bool IsEmpty() const { return m_length == 0; }
+
+	qpAllocator & GetAllocator() const { return *m_allocator; }
+
+	qpHashTable & operator=( const qpHashTable & other );
+	qpHashTable & operator=( qpHashTable && other ) noexcept;
+
+	QP_ITERATORS( Iterator, Iterator( this, 0 ), Iterator( this, m_capacity ) )
+protected:
+	enum : uint64 {
+		INVALID_INDEX = ~0ull,
+		MIN_CAPACITY = 8
+	};
+
+	template < typename _lookup_ >
+	uint64 FindIndex( const _lookup_ & key ) const;
+	// constructs the entry from args if there isn't one with the key, returns the entry and whether it was inserted.
+	template < typename _lookup_, typename ... _args_ >
+	_entry_ * FindOrEmplace( const _lookup_ & key, bool & outInserted, _args_ &&... args );
+
+	_entry_ * EntryAt( const uint64 index ) const { return &m_entries[ index ]; }
+private:
+	_entry_ * m_entries = NULL;
+	// distance of every slot's entry from the slot its hash points at plus one, zero for empty slots.
+	uint32 * m_distances = NULL;
+	uint64 m_capacity = 0;
+	uint64 m_length = 0;
+	uint32 m_shift = 64;
+	qpAllocator * m_allocator = &qpGetDefaultAllocator();
+
+	template < typename _lookup_ >
+	uint64 HomeIndex( const _lookup_ & key ) const;
+	// places an entry that isn't in the table yet, returns the slot it ended up in.
+	uint64 InsertUnique( _entry_ && entry );
+	bool NeedsToGrow( const uint64 numEntries ) const { return numEntries > m_capacity - m_capacity / 8; }
+	void FreeTable();
+};
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::qpHashTable( const qpHashTable & other ) : m_allocator( other.m_allocator ) {
+	Reserve( other.m_length );
+	for ( const _entry_ & entry : other ) {
+		InsertUnique( _entry_( entry ) );
+	}
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::qpHashTable( qpHashTable && other ) noexcept
+	: m_entries( other.m_entries ), m_distances( other.m_distances ), m_capacity( other.m_capacity ), m_length( other.m_length ), m_shift( other.m_shift ), m_allocator( other.m_allocator ) {
+	other.m_entries = NULL;
+	other.m_distances = NULL;
+	other.m_capacity = 0;
+	other.m_length = 0;
+	other.m_shift = 64;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::~qpHashTable() {
+	FreeTable();
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+bool qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::Remove( const _lookup_ & key ) {
+	uint64 index = FindIndex( key );
+	if ( index == INVALID_INDEX ) {
+		return false;
+	}
+	m_entries[ index ].~_entry_();
+	// shifts the following entries back a slot until one is empty or already in its own slot.
+	const uint64 mask = m_capacity - 1;
+	uint64 next = ( index + 1 ) & mask;
+	while ( m_distances[ next ] > 1 ) {
+		new ( &m_entries[ index ] ) _entry_( qpMove( m_entries[ next ] ) );
+		m_entries[ next ].~_entry_();
+		m_distances[ index ] = m_distances[ next ] - 1;
+		index = next;
+		next = ( next + 1 ) & mask;
+	}
+	m_distances[ index ] = 0;
+	--m_length;
+	return true;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+void qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::Reserve( const uint64 numEntries ) {
+	if ( NeedsToGrow( numEntries ) ) {
+		Rehash( numEntries + numEntries / 7 + 1 );
+	}
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+void qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::Rehash( const uint64 capacity ) {
+	uint64 newCapacity = std::bit_ceil( qpMath::Max( capacity, static_cast< uint64 >( MIN_CAPACITY ) ) );
+	while ( m_length > newCapacity - newCapacity / 8 ) {
+		newCapacity *= 2;
+	}
+	if ( newCapacity == m_capacity ) {
+		return;
+	}
+
+	_entry_ * oldEntries = m_entries;
+	uint32 * oldDistances = m_distances;
+	const uint64 oldCapacity = m_capacity;
+
+	m_entries = static_cast< _entry_ * >( m_allocator->Allocate( newCapacity * sizeof( _entry_ ), alignof( _entry_ ) ) );
+	m_distances = static_cast< uint32 * >( m_allocator->Allocate( newCapacity * sizeof( uint32 ), alignof( uint32 ) ) );
+	QP_ASSERT_MSG( ( m_entries != NULL ) && ( m_distances != NULL ), "Hash table allocator is out of memory." );
+	qpZeroMemory( m_distances, newCapacity * sizeof( uint32 ) );
+	m_capacity = newCapacity;
+	m_shift = 64 - static_cast< uint32 >( std::countr_zero( newCapacity ) );
+	m_length = 0;
+
+	for ( uint64 index = 0; index < oldCapacity; ++index ) {
+		if ( oldDistances[ index ] != 0 ) {
+			InsertUnique( qpMove( oldEntries[ index ] ) );
+			oldEntries[ index ].~_entry_();
+		}
+	}
+	if ( oldEntries != NULL ) {
+		m_allocator->Free( oldEntries, oldCapacity * sizeof( _entry_ ) );
+		m_allocator->Free( oldDistances, oldCapacity * sizeof( uint32 ) );
+	}
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+void qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::Clear() {
+	for ( uint64 index = 0; index < m_capacity; ++index ) {
+		if ( m_distances[ index ] != 0 ) {
+			m_entries[ index ].~_entry_();
+			m_distances[ index ] = 0;
+		}
+	}
+	m_length = 0;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ > & qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::operator=( const qpHashTable & other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	Clear();
+	Reserve( other.m_length );
+	for ( const _entry_ & entry : other ) {
+		InsertUnique( _entry_( entry ) );
+	}
+	return *this;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ > & qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::operator=( qpHashTable && other ) noexcept {
+	if ( this == &other ) {
+		return *this;
+	}
+	FreeTable();
+	m_entries = other.m_entries;
+	m_distances = other.m_distances;
+	m_capacity = other.m_capacity;
+	m_length = other.m_length;
+	m_shift = other.m_shift;
+	m_allocator = other.m_allocator;
+	other.m_entries = NULL;
+	other.m_distances = NULL;
+	other.m_capacity = 0;
+	other.m_length = 0;
+	other.m_shift = 64;
+	return *this;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+uint64 qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::FindIndex( const _lookup_ & key ) const {
+	if ( m_length == 0 ) {
+		return INVALID_INDEX;
+	}
+	const uint64 mask = m_capacity - 1;
+	uint64 index = HomeIndex( key );
+	for ( uint32 distance = 1; m_distances[ index ] >= distance; ++distance ) {
+		if ( ( m_distances[ index ] == distance ) && _equal_()( _keyOf_::KeyOf( m_entries[ index ] ), key ) ) {
+			return index;
+		}
+		index = ( index + 1 ) & mask;
+	}
+	return INVALID_INDEX;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+template < typename _lookup_, typename ... _args_ >
+_entry_ * qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::FindOrEmplace( const _lookup_ & key, bool & outInserted, _args_ &&... args ) {
+	const uint64 index = FindIndex( key );
+	if ( index != INVALID_INDEX ) {
+		outInserted = false;
+		return &m_entries[ index ];
+	}
+	if ( NeedsToGrow( m_length + 1 ) ) {
+		Rehash( m_capacity * 2 );
+	}
+	outInserted = true;
+	return &m_entries[ InsertUnique( _entry_( qpForward< _args_ >( args )... ) ) ];
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+template < typename _lookup_ >
+uint64 qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::HomeIndex( const _lookup_ & key ) const {
+	// fibonacci hashing picks the slot from the high bits so hashes that only differ in their high bits still spread out.
+	return ( _hash_()( key ) * 0x9e3779b97f4a7c15ull ) >> m_shift;
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+uint64 qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::InsertUnique( _entry_ && entry ) {
+	const uint64 mask = m_capacity - 1;
+	uint64 index = HomeIndex( _keyOf_::KeyOf( entry ) );
+	uint32 distance = 1;
+	uint64 insertedIndex = INVALID_INDEX;
+	_entry_ carried( qpMove( entry ) );
+	while ( true ) {
+		if ( m_distances[ index ] == 0 ) {
+			new ( &m_entries[ index ] ) _entry_( qpMove( carried ) );
+			m_distances[ index ] = distance;
+			++m_length;
+			return ( insertedIndex != INVALID_INDEX ) ? insertedIndex : index;
+		}
+		if ( m_distances[ index ] < distance ) {
+			// the entry here is closer to its slot, it gives the slot up and continues probing instead.
+			_entry_ displaced( qpMove( m_entries[ index ] ) );
+			m_entries[ index ] = qpMove( carried );
+			carried = qpMove( displaced );
+			const uint32 displacedDistance = m_distances[ index ];
+			m_distances[ index ] = distance;
+			distance = displacedDistance;
+			if ( insertedIndex == INVALID_INDEX ) {
+				insertedIndex = index;
+			}
+		}
+		index = ( index + 1 ) & mask;
+		++distance;
+	}
+}
+
+template < typename _key_, typename _entry_, typename _keyOf_, typename _hash_, typename _equal_ >
+void qpHashTable< _key_, _entry_, _keyOf_, _hash_, _equal_ >::FreeTable() {
+	if ( m_entries == NULL ) {
+		return;
+	}
+	Clear();
+	m_allocator->Free( m_entries, m_capacity * sizeof( _entry_ ) );
+	m_allocator->Free( m_distances, m_capacity * sizeof( uint32 ) );
+	m_entries = NULL;
+	m_distances = NULL;
+	m_capacity = 0;
+	m_shift = 64;
+}
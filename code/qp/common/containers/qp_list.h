@@ -1,28 +1,43 @@
 #pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_type_traits.h"
 #include "qp/common/debug/qp_debug.h"
 #include "qp/common/math/qp_math.h"
 #include "qp/common/utilities/qp_algorithms.h"
+#include "qp/common/utilities/qp_utility.h"
 #include "qp_array_view.h"
+#include <cstring>
 #include <initializer_list>
+#include <new>
 #include <type_traits>
 
+// Growable array. Only the first Length() items are constructed, the rest of the capacity is raw memory,
+// so reserving doesn't construct anything and removing an item destroys it.
+// Trivially relocatable items are moved with memcpy and grown through the allocator's Reallocate.
 template< typename _type_ >
 class qpList {
 	friend class qpArrayView< _type_ >;
 public:
 	QP_FORWARD_ITERATOR( Iterator, qpList, _type_ )
 
+	// doesn't allocate until the first item is added.
 	qpList();
+	// the list allocates its items through allocator, which has to outlive the list.
+	explicit qpList( qpAllocator & allocator );
 	qpList( int size );
 	qpList( int size, const _type_ & initValue );
 	qpList( std::initializer_list< _type_ > initializerList );
 	qpList( const qpList & other );
 	qpList( qpList && other ) noexcept;
+	~qpList();
 
 	void Push( const _type_ & item );
 	void Push( _type_ && item );
 	template < typename ... _args_ >
 	_type_ & Emplace( _args_ &&... args );
+	// constructs the item at index, the items from index on move up by one.
+	template < typename ... _args_ >
+	_type_ & EmplaceAt( const uint64 index, _args_ &&... args );
 	void Pop();
 	void PopFirst();
 
@@ -44,22 +59,39 @@ public:
 	uint64 Capacity() const { return m_capacity; }
 	bool IsEmpty() const { return m_length == 0; }
 
+	qpAllocator & GetAllocator() const { return *m_allocator; }
+
 	_type_ & operator[]( const uint64 index );
 	const _type_ & operator[]( const uint64 index ) const;
 
 	qpList & operator=( const qpList & other );
 	qpList & operator=( qpList && other ) noexcept;
 
-	QP_ITERATORS( Iterator, Iterator( &m_data[ 0 ] ), Iterator( &m_data[ m_length ] ) )
+	QP_ITERATORS( Iterator, Iterator( m_data ), Iterator( m_data + m_length ) )
 private:
 	uint64 m_capacity = 0;
 	uint64 m_length = 0;
 	_type_ * m_data = NULL;
+	qpAllocator * m_allocator = &qpGetDefaultAllocator();
+
+	// grows the capacity geometrically so pushing is amortized O(1).
+	void Grow( const uint64 minCapacity );
+	void SetCapacity( const uint64 capacity );
+	void CopyConstructItems( const _type_ * items, const uint64 count );
+	void DestroyItems( const uint64 from, const uint64 to );
+	void FreeData();
 };
 
+// lists only own their items through a pointer so they can be moved bytewise.
+template< typename _type_ >
+QP_INLINE constexpr bool IsTriviallyRelocatable< qpList< _type_ > > = true;
+
 template< typename _type_ >
 qpList< _type_ >::qpList() {
-	Reserve( 1 );
+}
+
+template< typename _type_ >
+qpList< _type_ >::qpList( qpAllocator & allocator ) : m_allocator( &allocator ) {
 }
 
 template< typename _type_ >
@@ -69,26 +101,27 @@ qpList< _type_ >::qpList( int size ) {
 
 template< typename _type_ >
 qpList<_type_>::qpList( int size, const _type_ & initValue ) {
-	Resize( size );
+	Reserve( size );
 	for ( int index = 0; index < size; ++index ) {
-		m_data[ index ] = initValue;
+		new ( &m_data[ index ] ) _type_( initValue );
 	}
+	m_length = size;
 }
 
 template< typename _type_ >
 qpList< _type_ >::qpList( std::initializer_list< _type_ > initializerList ) {
-	Reserve( static_cast< int >( initializerList.size() ) );
-	m_length = qpCopy( m_data, static_cast< uint64 >( m_capacity ), initializerList.begin(), initializerList.size() );
+	Reserve( initializerList.size() );
+	CopyConstructItems( initializerList.begin(), initializerList.size() );
 }
 
 template< typename _type_ >
 qpList<_type_>::qpList( const qpList & other ) {
 	Reserve( other.m_length );
-	qpCopy( m_data, m_capacity, other.m_data, other.m_length );
+	CopyConstructItems( other.m_data, other.m_length );
 }
 
 template< typename _type_ >
-qpList<_type_>::qpList( qpList && other ) noexcept {
+qpList<_type_>::qpList( qpList && other ) noexcept : m_allocator( other.m_allocator ) {
 	m_data = other.m_data;
 	m_capacity = other.m_capacity;
 	m_length = other.m_length;
@@ -97,6 +130,11 @@ qpList<_type_>::qpList( qpList && other ) noexcept {
 	other.m_length = 0;
 }
 
+template< typename _type_ >
+qpList< _type_ >::~qpList() {
+	FreeData();
+}
+
 template< typename _type_ >
 void qpList< _type_ >::Push( const _type_ & item ) {
 	Emplace( item );
@@ -104,23 +142,53 @@ void qpList< _type_ >::Push( const _type_ & item ) {
 
 template< typename _type_ >
 void qpList< _type_ >::Push( _type_ && item ) {
-	Emplace( item );
+	Emplace( qpMove( item ) );
 }
 
 template< typename _type_ >
 template< typename ... _args_ >
 _type_ & qpList< _type_ >::Emplace( _args_ &&... args ) {
-	if ( ( m_length + 1 ) > m_capacity ) {
-		Reserve( m_capacity * 2 );
+	if ( m_length == m_capacity ) {
+		// the arguments can refer to an item in the list, so the new item is made before the items move.
+		_type_ item( qpForward< _args_ >( args )... );
+		Grow( m_length + 1 );
+		new ( &m_data[ m_length ] ) _type_( qpMove( item ) );
+	} else {
+		new ( &m_data[ m_length ] ) _type_( qpForward< _args_ >( args )... );
 	}
+	return m_data[ m_length++ ];
+}
 
-	return m_data[ m_length++ ] = qpMove( _type_( qpForward< _args_ >( args )... ) );
+template< typename _type_ >
+template< typename ... _args_ >
+_type_ & qpList< _type_ >::EmplaceAt( const uint64 index, _args_ &&... args ) {
+	QP_ASSERT_MSG( index <= m_length, "Index is out of bounds." );
+	if ( index == m_length ) {
+		return Emplace( qpForward< _args_ >( args )... );
+	}
+	_type_ item( qpForward< _args_ >( args )... );
+	if ( m_length == m_capacity ) {
+		Grow( m_length + 1 );
+	}
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		memmove( static_cast< void * >( &m_data[ index + 1 ] ), &m_data[ index ], ( m_length - index ) * sizeof( _type_ ) );
+		new ( &m_data[ index ] ) _type_( qpMove( item ) );
+	} else {
+		new ( &m_data[ m_length ] ) _type_( qpMove( m_data[ m_length - 1 ] ) );
+		for ( uint64 itemIndex = m_length - 1; itemIndex > index; --itemIndex ) {
+			m_data[ itemIndex ] = qpMove( m_data[ itemIndex - 1 ] );
+		}
+		m_data[ index ] = qpMove( item );
+	}
+	++m_length;
+	return m_data[ index ];
 }
 
 template< typename _type_ >
 void qpList< _type_ >::Pop() {
 	if ( m_length > 0 ) {
 		m_length--;
+		m_data[ m_length ].~_type_();
 	}
 }
 
@@ -158,45 +226,50 @@ void qpList<_type_>::RemoveIndex ( const uint64 index ) {
 	if ( index >= m_length ) {
 		return;
 	}
-	qpCopyOverlapped( &m_data[ index ], m_length - index, &m_data[ index + 1 ], m_length - index - 1);
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		m_data[ index ].~_type_();
+		memmove( static_cast< void * >( &m_data[ index ] ), &m_data[ index + 1 ], ( m_length - index - 1 ) * sizeof( _type_ ) );
+	} else {
+		for ( uint64 itemIndex = index; itemIndex + 1 < m_length; ++itemIndex ) {
+			m_data[ itemIndex ] = qpMove( m_data[ itemIndex + 1 ] );
+		}
+		m_data[ m_length - 1 ].~_type_();
+	}
 	--m_length;
 }
 
 template< typename _type_ >
 void qpList< _type_ >::ShrinkToFit() {
+	if ( m_capacity > m_length ) {
+		SetCapacity( m_length );
+	}
 }
 
 template< typename _type_ >
 void qpList< _type_ >::Reserve( const uint64 capacity ) {
 	if ( m_capacity < capacity ) {
-		_type_ * newData = new _type_[ capacity ] {};
-		qpCopy( newData, capacity, m_data, m_length );
-		delete[] m_data;
-		m_data = newData;
-		m_capacity = capacity;
+		SetCapacity( capacity );
 	}
 }
 
 template< typename _type_ >
 void qpList< _type_ >::Resize( const uint64 length ) {
-	Reserve( length );
-	int64 lengthDiff = qpVerifyStaticCast< int64 >( m_length ) - qpVerifyStaticCast< int64 >( length );
-
-	if ( lengthDiff < 0 ) {
-		for ( uint64 index = 0; index < qpVerifyStaticCast< uint64 >( qpMath::Abs( lengthDiff ) ); index++ ) {
-			m_data[ m_length + index ] = _type_();
+	if ( length > m_length ) {
+		if ( length > m_capacity ) {
+			Grow( length );
 		}
-	} else if ( lengthDiff > 0 ) {
-		for ( uint64 index = 0; index < qpVerifyStaticCast< uint64 >( lengthDiff ); index++ ) {
-			m_data[ m_length - index ] = _type_();
+		for ( uint64 index = m_length; index < length; ++index ) {
+			new ( &m_data[ index ] ) _type_();
 		}
+	} else {
+		DestroyItems( length, m_length );
 	}
-
 	m_length = length;
 }
 
 template< typename _type_ >
 void qpList< _type_ >::Clear() {
+	DestroyItems( 0, m_length );
 	m_length = 0;
 }
 
@@ -214,13 +287,22 @@ const _type_ & qpList< _type_ >::operator[]( const uint64 index ) const {
 
 template< typename _type_ >
 qpList< _type_ > & qpList< _type_ >::operator=( const qpList & other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	Clear();
 	Reserve( other.m_length );
-	qpCopy( m_data, m_capacity, other.m_data, other.m_length );
+	CopyConstructItems( other.m_data, other.m_length );
 	return *this;
 }
 
 template< typename _type_ >
 qpList< _type_ > & qpList< _type_ >::operator=( qpList && other ) noexcept {
+	if ( this == &other ) {
+		return *this;
+	}
+	FreeData();
+	m_allocator = other.m_allocator;
 	m_data = other.m_data;
 	m_capacity = other.m_capacity;
 	m_length = other.m_length;
@@ -229,3 +311,73 @@ qpList< _type_ > & qpList< _type_ >::operator=( qpList && other ) noexcept {
 	other.m_length = 0;
 	return *this;
 }
+
+template< typename _type_ >
+void qpList< _type_ >::Grow( const uint64 minCapacity ) {
+	SetCapacity( qpMath::Max( m_capacity * 2, minCapacity ) );
+}
+
+template< typename _type_ >
+void qpList< _type_ >::SetCapacity( const uint64 capacity ) {
+	QP_ASSERT_MSG( capacity >= m_length, "Can't set the capacity of a list below its length." );
+	if ( capacity == 0 ) {
+		FreeData();
+		return;
+	}
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		if ( m_data != NULL ) {
+			_type_ * newData = static_cast< _type_ * >( m_allocator->Reallocate( m_data, m_capacity * sizeof( _type_ ), capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+			QP_ASSERT_RELEASE_MSG( newData != NULL, "List allocator is out of memory." );
+			m_data = newData;
+			m_capacity = capacity;
+			return;
+		}
+	}
+	_type_ * newData = static_cast< _type_ * >( m_allocator->Allocate( capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+	QP_ASSERT_RELEASE_MSG( newData != NULL, "List allocator is out of memory." );
+	for ( uint64 index = 0; index < m_length; ++index ) {
+		new ( &newData[ index ] ) _type_( qpMove( m_data[ index ] ) );
+		m_data[ index ].~_type_();
+	}
+	if ( m_data != NULL ) {
+		m_allocator->Free( m_data, m_capacity * sizeof( _type_ ) );
+	}
+	m_data = newData;
+	m_capacity = capacity;
+}
+
+template< typename _type_ >
+void qpList< _type_ >::CopyConstructItems( const _type_ * items, const uint64 count ) {
+	QP_ASSERT_MSG( m_length + count <= m_capacity, "Copying more items than the list has room for." );
+	if constexpr ( IsTrivialToCopy< _type_ > ) {
+		if ( count > 0 ) {
+			memcpy( static_cast< void * >( &m_data[ m_length ] ), items, count * sizeof( _type_ ) );
+		}
+	} else {
+		for ( uint64 index = 0; index < count; ++index ) {
+			new ( &m_data[ m_length + index ] ) _type_( items[ index ] );
+		}
+	}
+	m_length += count;
+}
+
+template< typename _type_ >
+void qpList< _type_ >::DestroyItems( const uint64 from, const uint64 to ) {
+	if constexpr ( !std::is_trivially_destructible_v< _type_ > ) {
+		for ( uint64 index = from; index < to; ++index ) {
+			m_data[ index ].~_type_();
+		}
+	}
+}
+
+template< typename _type_ >
+void qpList< _type_ >::FreeData() {
+	if ( m_data == NULL ) {
+		return;
+	}
+	DestroyItems( 0, m_length );
+	m_allocator->Free( m_data, m_capacity * sizeof( _type_ ) );
+	m_data = NULL;
+	m_capacity = 0;
+	m_length = 0;
+}
@@ -7,6 +7,7 @@ class qpQueue {
 public:
 	qpQueue() = default;
 	qpQueue( const uint64 initialCapacity );
+	explicit qpQueue( qpAllocator & allocator );
 	void Push( const _type_ & item );
 	void Push( _type_ && item );
 	template < typename ... _args_ >
@@ -19,19 +20,24 @@ public:
 
 	uint64 Length() const;
 
-	bool IsEmpty() const { return m_tail == m_head; }
-	bool IsFull() const { return m_tail == m_items.Length(); }
+	bool IsEmpty() const { return m_length == 0; }
+	bool IsFull() const { return m_length == m_items.Length(); }
 private:
 	qpList< _type_ > m_items;
 	uint64 m_head = 0;
-	uint64 m_tail = 0;
-	
+	uint64 m_length = 0;
+
+	void Grow();
 };
 
 template< typename _type_ >
 qpQueue< _type_ >::qpQueue ( const uint64 initialCapacity ) 
 	: m_items( initialCapacity ) {}
 
+template< typename _type_ >
+qpQueue< _type_ >::qpQueue( qpAllocator & allocator )
+	: m_items( allocator ) {}
+
 template< typename _type_ >
 void qpQueue< _type_ >::Push( const _type_ & item ) {
 	Emplace( item );
@@ -44,61 +50,63 @@ void qpQueue< _type_ >::Push( _type_ && item ) {
 
 template< typename _type_ >
 const _type_ & qpQueue< _type_ >::Peek() const {
-	QP_ASSERT_RELEASE_MSG( m_tail != m_head, "Peeking empty queue!");
+	QP_ASSERT_RELEASE_MSG( m_length != 0, "Peeking empty queue!");
 	return m_items[ m_head ];
 }
 
 template< typename _type_ >
 bool qpQueue< _type_ >::Pop ( _type_ & outItem ) {
-	const uint64 index = m_head;
-	if ( Pop() ) {
-		outItem = qpMove( m_items[ index ] );
-		return true;
+	if ( m_length == 0 ) {
+		return false;
 	}
-	return false;
+	outItem = qpMove( m_items[ m_head ] );
+	return Pop();
 }
 
 template< typename _type_ >
 bool qpQueue< _type_ >::Pop() {
-	if ( m_tail == m_head ) {
+	if ( m_length == 0 ) {
 		return false;
 	}
-	if ( m_tail == m_items.Length() ) {
-		m_tail = m_head;
-	}
 	m_head = ( m_head + 1 ) % m_items.Length();
+	--m_length;
 	return true;
 }
 
 template< typename _type_ >
 void qpQueue< _type_ >::Reserve( const uint64 newCapacity ) {
-	m_items.Reserve( newCapacity );
+	while ( m_items.Length() < newCapacity ) {
+		Grow();
+	}
 }
 
 template< typename _type_ >
 uint64 qpQueue<_type_>::Length () const {
-	if ( m_tail == m_head ) {
-		return 0;
-	}
-	if ( m_tail == m_items.Length() ) {
-		return m_items.Length();
-	}
-	if ( m_tail > m_head ) {
-		return m_tail - m_head;
-	}
-	return m_tail + m_items.Length() - m_head;
+	return m_length;
 }
 
 template< typename _type_ >
 template< typename ... _args_ >
 _type_ & qpQueue< _type_ >::Emplace ( _args_ &&... args ) {
-	if ( m_tail == m_items.Length() ) {
-		++m_tail;
-		return m_items.Emplace( qpForward< _args_ >( args )... );
+	if ( IsFull() ) {
+		Grow();
 	}
 
-	const uint64 insertIndex = m_tail;
+	const uint64 insertIndex = ( m_head + m_length ) % m_items.Length();
 	m_items[ insertIndex ] = qpMove( _type_( qpForward< _args_ >( args )... ) );
-	m_tail = ( m_tail + 1 ) % m_items.Length();
+	++m_length;
 	return m_items[ insertIndex ];
 }
+
+template< typename _type_ >
+void qpQueue< _type_ >::Grow() {
+	// unwrap the items into a bigger list so the head starts at index 0 again.
+	const uint64 newLength = qpMath::Max( m_items.Length() * 2, 8ull );
+	qpList< _type_ > items( m_items.GetAllocator() );
+	items.Resize( newLength );
+	for ( uint64 index = 0; index < m_length; ++index ) {
+		items[ index ] = qpMove( m_items[ ( m_head + index ) % m_items.Length() ] );
+	}
+	m_items = qpMove( items );
+	m_head = 0;
+}
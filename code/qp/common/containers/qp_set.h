@@ -1,4 +1,5 @@
 #pragma once
+#include "qp/common/allocation/qp_pool_allocator.h"
 #include "qp/common/core/qp_types.h"
 #include "qp/common/utilities/qp_comparison_macros.h"
 #include "qp/common/utilities/qp_initializer_list.h"
@@ -78,6 +79,8 @@ public:
 		qpNode * m_node = NULL;
 	};
 	qpSet();
+	// nodes are allocated through allocator, which has to outlive the set.
+	explicit qpSet( qpAllocator & allocator );
 	qpSet( qpInitializerList< _type_ > initializerList );
 	qpSet( const _type_ * begin, const _type_ * end );
 	~qpSet();
@@ -100,6 +103,8 @@ private:
 	typedef typename qpNode::color_t color_t;
 	qpNode * m_root = NULL;
 	int m_length = 0;
+	// nodes come from the set's own pool so they are close together in memory and don't go through the global heap.
+	qpPoolAllocator m_nodeAllocator { sizeof( qpNode ), alignof( qpNode ), 16 };
 	bool m_leftLeftRotationFlag = false;
 	bool m_rightRightRotationFlag = false;
 	bool m_leftRightRotationFlag = false;
@@ -115,6 +120,7 @@ private:
 	void FixDoubleBlack_r( qpNode * node );
 	void DeleteNode_r( qpNode * nodeB );
 	void DeleteTree_r( qpNode *& node );
+	void DeleteNode( qpNode * node );
 	qpNode * GetSuccessor( qpNode * node );
 	qpNode * FindReplacement( qpNode * node );
 	static qpNode * Min( qpNode * node );
@@ -163,6 +169,9 @@ void qpSet< _type_ >::qpNode::MoveDown( qpNode * newParent ) {
 template< typename _type_ >
 qpSet< _type_ >::qpSet() {}
 
+template< typename _type_ >
+qpSet< _type_ >::qpSet( qpAllocator & allocator ) : m_nodeAllocator( sizeof( qpNode ), alignof( qpNode ), 16, allocator ) {}
+
 template< typename _type_ >
 qpSet< _type_ >::qpSet( qpInitializerList< _type_ > initializerList ) : qpSet( initializerList.begin(), initializerList.end() ) {}
 
@@ -224,7 +233,7 @@ typename qpSet< _type_ >::qpNode * qpSet< _type_ >::BinarySearch_r( qpNode * nod
 template< typename _type_ >
 void qpSet< _type_ >::Insert_r( qpNode *& node, const _type_ & value ) {
 	if ( node == NULL ) {
-		node = new qpNode( color_t::RED, value );
+		node = new ( m_nodeAllocator.Allocate() ) qpNode( color_t::RED, value );
 		if ( node == m_root ) {
 			node->m_color = color_t::BLACK;
 		}
@@ -415,7 +424,7 @@ void qpSet< _type_ >::DeleteNode_r( qpNode * nodeB ) {
 				parent->m_right = NULL;
 			}
 		}
-		delete nodeB;
+		DeleteNode( nodeB );
 		return;
 	}
 
@@ -423,14 +432,14 @@ void qpSet< _type_ >::DeleteNode_r( qpNode * nodeB ) {
 		if ( nodeB == m_root ) {
 			nodeB->m_value = nodeA->m_value;
 			nodeB->m_left = nodeB->m_right = NULL;
-			delete nodeA;
+			DeleteNode( nodeA );
 		} else {
 			if ( nodeB->IsOnLeft() ) {
 				parent->m_left = nodeA;
 			} else {
 				parent->m_right = nodeA;
 			}
-			delete nodeB;
+			DeleteNode( nodeB );
 			nodeA->m_parent = parent;
 			if ( bothBlack ) {
 				FixDoubleBlack_r( nodeA );
@@ -452,10 +461,18 @@ void qpSet< _type_ >::DeleteTree_r( qpNode *& node ) {
 		DeleteTree_r( node->m_right );
 	}
 
-	delete node;
+	DeleteNode( node );
 	node = NULL;
 }
 
+template< typename _type_ >
+void qpSet< _type_ >::DeleteNode( qpNode * node ) {
+	if ( node != NULL ) {
+		node->~qpNode();
+		m_nodeAllocator.Free( node );
+	}
+}
+
 template< typename _type_ >
 typename qpSet< _type_ >::qpNode * qpSet< _type_ >::GetSuccessor( qpNode * node ) {
 	qpNode * temp = node;
@@ -0,0 +1,233 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_macros.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include "qp_list.h"
+#include <iterator>
+
+// Handle to an item in a qpSlotMap. The handle packs the index of the item's slot with the generation the
+// slot had when the item was inserted, removing the item bumps the generation so stale handles are detected.
+// A default constructed handle is never valid.
+template < typename _type_ >
+struct slotHandle_t {
+	enum : uint32 {
+		INDEX_BITS = 20,
+		GENERATION_BITS = 32 - INDEX_BITS,
+		MAX_SLOTS = 1u << INDEX_BITS,
+		INDEX_MASK = MAX_SLOTS - 1,
+		GENERATION_MASK = ( 1u << GENERATION_BITS ) - 1
+	};
+
+	uint32 value = 0;
+
+	static slotHandle_t Make( const uint32 index, const uint32 generation ) { return slotHandle_t { ( generation << INDEX_BITS ) | index }; }
+
+	uint32 Index() const { return value & INDEX_MASK; }
+	uint32 Generation() const { return value >> INDEX_BITS; }
+	// only says the handle has been given out by a slot map, use qpSlotMap::Contains to check if the item is still alive.
+	bool IsValid() const { return value != 0; }
+
+	bool operator==( const slotHandle_t & other ) const = default;
+};
+
+// Stores items densely so iterating them is as fast as iterating a list, and hands out generation checked
+// handles that stay valid until the item is removed. Insert, remove and lookup by handle are O(1).
+// Removing an item moves the last item into its place, so the order of the items isn't kept and pointers
+// to items are only valid until the next insert or remove; keep the handle instead.
+// Freed slots are only reused oldest first once enough of them have piled up, so a slot's generation wraps around
+// late and a stale handle is very unlikely to match a new item.
+template < typename _type_ >
+class qpSlotMap {
+public:
+	using handle_t = slotHandle_t< _type_ >;
+
+	QP_FORWARD_ITERATOR( Iterator, qpSlotMap, _type_ )
+
+	qpSlotMap() = default;
+	// the map allocates its items and slots through allocator, which has to outlive the map.
+	explicit qpSlotMap( qpAllocator & allocator );
+
+	handle_t Insert( const _type_ & item );
+	handle_t Insert( _type_ && item );
+	template < typename ... _args_ >
+	handle_t Emplace( _args_ &&... args );
+	// returns false if the handle is stale.
+	bool Remove( const handle_t handle );
+
+	bool Contains( const handle_t handle ) const;
+	// returns NULL if the handle is stale.
+	_type_ * Get( const handle_t handle );
+	const _type_ * Get( const handle_t handle ) const;
+
+	// handle of the item at index when iterating the items densely.
+	handle_t HandleAt( const uint64 index ) const;
+
+	_type_ * Data() const { return m_items.Data(); }
+
+	void Reserve( const uint64 capacity );
+	// removes every item, handles to them become stale.
+	void Clear();
+
+	uint64 Length() const { return m_items.Length(); }
+	bool IsEmpty() const { return m_items.IsEmpty(); }
+
+	_type_ & operator[]( const handle_t handle );
+	const _type_ & operator[]( const handle_t handle ) const;
+
+	QP_ITERATORS( Iterator, Iterator( m_items.Data() ), Iterator( m_items.Data() + m_items.Length() ) )
+private:
+	enum : uint32 {
+		INVALID_INDEX = ~0u,
+		MIN_FREE_SLOTS = 1024
+	};
+	struct slot_t {
+		// index of the item while the slot is in use, the next free slot while it is free.
+		uint32 index = INVALID_INDEX;
+		uint32 generation = 1;
+	};
+
+	qpList< _type_ > m_items;
+	// slot of every item, parallel to m_items.
+	qpList< uint32 > m_itemSlots;
+	qpList< slot_t > m_slots;
+	uint32 m_firstFreeSlot = INVALID_INDEX;
+	uint32 m_lastFreeSlot = INVALID_INDEX;
+	uint32 m_numFreeSlots = 0;
+
+	handle_t AllocateSlot();
+	void FreeSlot( const uint32 slotIndex );
+};
+
+template < typename _type_ >
+qpSlotMap< _type_ >::qpSlotMap( qpAllocator & allocator ) : m_items( allocator ), m_itemSlots( allocator ), m_slots( allocator ) {
+}
+
+template < typename _type_ >
+typename qpSlotMap< _type_ >::handle_t qpSlotMap< _type_ >::Insert( const _type_ & item ) {
+	return Emplace( item );
+}
+
+template < typename _type_ >
+typename qpSlotMap< _type_ >::handle_t qpSlotMap< _type_ >::Insert( _type_ && item ) {
+	return Emplace( qpMove( item ) );
+}
+
+template < typename _type_ >
+template < typename ... _args_ >
+typename qpSlotMap< _type_ >::handle_t qpSlotMap< _type_ >::Emplace( _args_ &&... args ) {
+	const handle_t handle = AllocateSlot();
+	m_slots[ handle.Index() ].index = static_cast< uint32 >( m_items.Length() );
+	m_items.Emplace( qpForward< _args_ >( args )... );
+	m_itemSlots.Push( handle.Index() );
+	return handle;
+}
+
+template < typename _type_ >
+bool qpSlotMap< _type_ >::Remove( const handle_t handle ) {
+	if ( !Contains( handle ) ) {
+		return false;
+	}
+	const uint32 slotIndex = handle.Index();
+	const uint32 itemIndex = m_slots[ slotIndex ].index;
+	const uint32 lastIndex = static_cast< uint32 >( m_items.Length() - 1 );
+	if ( itemIndex != lastIndex ) {
+		m_items[ itemIndex ] = qpMove( m_items[ lastIndex ] );
+		m_itemSlots[ itemIndex ] = m_itemSlots[ lastIndex ];
+		m_slots[ m_itemSlots[ itemIndex ] ].index = itemIndex;
+	}
+	m_items.Pop();
+	m_itemSlots.Pop();
+	FreeSlot( slotIndex );
+	return true;
+}
+
+template < typename _type_ >
+bool qpSlotMap< _type_ >::Contains( const handle_t handle ) const {
+	// free slots have already moved on to the next generation so only handles to live items match. once the
+	// generation wraps a stale handle can match a free slot again, so the slot's item also has to point back at it.
+	const uint32 slotIndex = handle.Index();
+	if ( ( slotIndex >= m_slots.Length() ) || ( m_slots[ slotIndex ].generation != handle.Generation() ) ) {
+		return false;
+	}
+	const uint32 itemIndex = m_slots[ slotIndex ].index;
+	return ( itemIndex != INVALID_INDEX ) && ( itemIndex < m_items.Length() ) && ( m_itemSlots[ itemIndex ] == slotIndex );
+}
+
+template < typename _type_ >
+_type_ * qpSlotMap< _type_ >::Get( const handle_t handle ) {
+	return Contains( handle ) ? &m_items[ m_slots[ handle.Index() ].index ] : NULL;
+}
+
+template < typename _type_ >
+const _type_ * qpSlotMap< _type_ >::Get( const handle_t handle ) const {
+	return Contains( handle ) ? &m_items[ m_slots[ handle.Index() ].index ] : NULL;
+}
+
+template < typename _type_ >
+typename qpSlotMap< _type_ >::handle_t qpSlotMap< _type_ >::HandleAt( const uint64 index ) const {
+	QP_ASSERT_MSG( index < m_items.Length(), "Index is out of bounds." );
+	const uint32 slotIndex = m_itemSlots[ index ];
+	return handle_t::Make( slotIndex, m_slots[ slotIndex ].generation );
+}
+
+template < typename _type_ >
+void qpSlotMap< _type_ >::Reserve( const uint64 capacity ) {
+	m_items.Reserve( capacity );
+	m_itemSlots.Reserve( capacity );
+	m_slots.Reserve( capacity );
+}
+
+template < typename _type_ >
+void qpSlotMap< _type_ >::Clear() {
+	while ( !m_items.IsEmpty() ) {
+		Remove( HandleAt( m_items.Length() - 1 ) );
+	}
+}
+
+template < typename _type_ >
+_type_ & qpSlotMap< _type_ >::operator[]( const handle_t handle ) {
+	QP_ASSERT_MSG( Contains( handle ), "Handle is stale or doesn't belong to this slot map." );
+	return m_items[ m_slots[ handle.Index() ].index ];
+}
+
+template < typename _type_ >
+const _type_ & qpSlotMap< _type_ >::operator[]( const handle_t handle ) const {
+	QP_ASSERT_MSG( Contains( handle ), "Handle is stale or doesn't belong to this slot map." );
+	return m_items[ m_slots[ handle.Index() ].index ];
+}
+
+template < typename _type_ >
+typename qpSlotMap< _type_ >::handle_t qpSlotMap< _type_ >::AllocateSlot() {
+	uint32 slotIndex = m_firstFreeSlot;
+	if ( ( m_numFreeSlots > MIN_FREE_SLOTS ) || ( ( slotIndex != INVALID_INDEX ) && ( m_slots.Length() == handle_t::MAX_SLOTS ) ) ) {
+		m_firstFreeSlot = m_slots[ slotIndex ].index;
+		if ( m_firstFreeSlot == INVALID_INDEX ) {
+			m_lastFreeSlot = INVALID_INDEX;
+		}
+		--m_numFreeSlots;
+	} else {
+		QP_ASSERT_RELEASE_MSG( m_slots.Length() < handle_t::MAX_SLOTS, "Slot map is out of slots." );
+		slotIndex = static_cast< uint32 >( m_slots.Length() );
+		m_slots.Emplace();
+	}
+	return handle_t::Make( slotIndex, m_slots[ slotIndex ].generation );
+}
+
+template < typename _type_ >
+void qpSlotMap< _type_ >::FreeSlot( const uint32 slotIndex ) {
+	slot_t & slot = m_slots[ slotIndex ];
+	// generation 0 is skipped so a default constructed handle never matches a slot.
+	slot.generation = ( slot.generation + 1 ) & handle_t::GENERATION_MASK;
+	if ( slot.generation == 0 ) {
+		slot.generation = 1;
+	}
+	slot.index = INVALID_INDEX;
+	if ( m_lastFreeSlot != INVALID_INDEX ) {
+		m_slots[ m_lastFreeSlot ].index = slotIndex;
+	} else {
+		m_firstFreeSlot = slotIndex;
+	}
+	m_lastFreeSlot = slotIndex;
+	++m_numFreeSlots;
+}
@@ -0,0 +1,375 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/core/qp_type_traits.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/math/qp_math.h"
+#include "qp/common/utilities/qp_utility.h"
+#include "qp_array_view.h"
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+// List with room for _inlineCapacity_ items inside the list itself, it only allocates once it grows past that.
+// Has the same interface as qpList, use it for lists that are nearly always short so they never touch the allocator.
+// Moving a list that fits inline moves its items one by one, so keep large inline capacities out of moved types.
+template< typename _type_, int _inlineCapacity_ >
+class qpSmallList {
+	friend class qpArrayView< _type_ >;
+public:
+	static_assert( _inlineCapacity_ > 0, "qpSmallList needs an inline capacity, use qpList otherwise." );
+
+	QP_FORWARD_ITERATOR( Iterator, qpSmallList, _type_ )
+
+	qpSmallList() = default;
+	// the list allocates through allocator once it outgrows its inline storage, the allocator has to outlive the list.
+	explicit qpSmallList( qpAllocator & allocator );
+	qpSmallList( int size );
+	qpSmallList( int size, const _type_ & initValue );
+	qpSmallList( std::initializer_list< _type_ > initializerList );
+	qpSmallList( const qpSmallList & other );
+	qpSmallList( qpSmallList && other ) noexcept;
+	~qpSmallList();
+
+	void Push( const _type_ & item );
+	void Push( _type_ && item );
+	template < typename ... _args_ >
+	_type_ & Emplace( _args_ &&... args );
+	void Pop();
+	void PopFirst();
+
+	_type_ & First();
+	_type_ & Last();
+	const _type_ & First() const;
+	const _type_ & Last() const;
+
+	_type_ * Data() const { return m_data; }
+
+	void RemoveIndex( const uint64 index );
+
+	// moves the items back inline if they fit.
+	void ShrinkToFit();
+	void Reserve( const uint64 capacity );
+	void Resize( const uint64 length );
+	void Clear();
+
+	uint64 Length() const { return m_length; }
+	uint64 Capacity() const { return m_capacity; }
+	bool IsEmpty() const { return m_length == 0; }
+	bool IsInline() const { return m_data == InlineData(); }
+
+	qpAllocator & GetAllocator() const { return *m_allocator; }
+
+	_type_ & operator[]( const uint64 index );
+	const _type_ & operator[]( const uint64 index ) const;
+
+	qpSmallList & operator=( const qpSmallList & other );
+	qpSmallList & operator=( qpSmallList && other ) noexcept;
+
+	QP_ITERATORS( Iterator, Iterator( m_data ), Iterator( m_data + m_length ) )
+private:
+	uint64 m_capacity = _inlineCapacity_;
+	uint64 m_length = 0;
+	_type_ * m_data = InlineData();
+	qpAllocator * m_allocator = &qpGetDefaultAllocator();
+	alignas( _type_ ) byte m_inlineData[ sizeof( _type_ ) * _inlineCapacity_ ];
+
+	_type_ * InlineData() const { return reinterpret_cast< _type_ * >( const_cast< byte * >( m_inlineData ) ); }
+
+	void Grow( const uint64 minCapacity );
+	void SetCapacity( const uint64 capacity );
+	void MoveItemsTo( _type_ * data );
+	void CopyConstructItems( const _type_ * items, const uint64 count );
+	void DestroyItems( const uint64 from, const uint64 to );
+	void FreeHeapData();
+	// moves the items of other into this list, which has to be empty, and leaves other empty.
+	void TakeItems( qpSmallList & other );
+};
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( qpAllocator & allocator ) : m_allocator( &allocator ) {
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( int size ) {
+	Resize( size );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( int size, const _type_ & initValue ) {
+	Reserve( size );
+	for ( int index = 0; index < size; ++index ) {
+		new ( &m_data[ index ] ) _type_( initValue );
+	}
+	m_length = size;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( std::initializer_list< _type_ > initializerList ) {
+	Reserve( initializerList.size() );
+	CopyConstructItems( initializerList.begin(), initializerList.size() );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( const qpSmallList & other ) {
+	Reserve( other.m_length );
+	CopyConstructItems( other.m_data, other.m_length );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::qpSmallList( qpSmallList && other ) noexcept : m_allocator( other.m_allocator ) {
+	TakeItems( other );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ >::~qpSmallList() {
+	DestroyItems( 0, m_length );
+	FreeHeapData();
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Push( const _type_ & item ) {
+	Emplace( item );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Push( _type_ && item ) {
+	Emplace( qpMove( item ) );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+template< typename ... _args_ >
+_type_ & qpSmallList< _type_, _inlineCapacity_ >::Emplace( _args_ &&... args ) {
+	if ( m_length == m_capacity ) {
+		// the arguments can refer to an item in the list, so the new item is made before the items move.
+		_type_ item( qpForward< _args_ >( args )... );
+		Grow( m_length + 1 );
+		new ( &m_data[ m_length ] ) _type_( qpMove( item ) );
+	} else {
+		new ( &m_data[ m_length ] ) _type_( qpForward< _args_ >( args )... );
+	}
+	return m_data[ m_length++ ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Pop() {
+	if ( m_length > 0 ) {
+		m_length--;
+		m_data[ m_length ].~_type_();
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::PopFirst() {
+	RemoveIndex( 0 );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+_type_ & qpSmallList< _type_, _inlineCapacity_ >::First() {
+	QP_ASSERT_MSG( m_length != 0, "Accessing first element but the list is empty." );
+	return m_data[ 0 ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+_type_ & qpSmallList< _type_, _inlineCapacity_ >::Last() {
+	QP_ASSERT_MSG( m_length != 0, "Accessing last element but the list is empty." );
+	return m_data[ m_length - 1 ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+const _type_ & qpSmallList< _type_, _inlineCapacity_ >::First() const {
+	QP_ASSERT_MSG( m_length != 0, "Accessing first element but the list is empty." );
+	return m_data[ 0 ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+const _type_ & qpSmallList< _type_, _inlineCapacity_ >::Last() const {
+	QP_ASSERT_MSG( m_length != 0, "Accessing last element but the list is empty." );
+	return m_data[ m_length - 1 ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::RemoveIndex( const uint64 index ) {
+	if ( index >= m_length ) {
+		return;
+	}
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		m_data[ index ].~_type_();
+		memmove( static_cast< void * >( &m_data[ index ] ), &m_data[ index + 1 ], ( m_length - index - 1 ) * sizeof( _type_ ) );
+	} else {
+		for ( uint64 itemIndex = index; itemIndex + 1 < m_length; ++itemIndex ) {
+			m_data[ itemIndex ] = qpMove( m_data[ itemIndex + 1 ] );
+		}
+		m_data[ m_length - 1 ].~_type_();
+	}
+	--m_length;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::ShrinkToFit() {
+	if ( m_capacity > m_length ) {
+		SetCapacity( m_length );
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Reserve( const uint64 capacity ) {
+	if ( m_capacity < capacity ) {
+		SetCapacity( capacity );
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Resize( const uint64 length ) {
+	if ( length > m_length ) {
+		if ( length > m_capacity ) {
+			Grow( length );
+		}
+		for ( uint64 index = m_length; index < length; ++index ) {
+			new ( &m_data[ index ] ) _type_();
+		}
+	} else {
+		DestroyItems( length, m_length );
+	}
+	m_length = length;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Clear() {
+	DestroyItems( 0, m_length );
+	m_length = 0;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+_type_ & qpSmallList< _type_, _inlineCapacity_ >::operator[]( const uint64 index ) {
+	QP_ASSERT_MSG( index < m_length, "Index is out of bounds." );
+	return m_data[ index ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+const _type_ & qpSmallList< _type_, _inlineCapacity_ >::operator[]( const uint64 index ) const {
+	QP_ASSERT_MSG( index < m_length, "Index is out of bounds." );
+	return m_data[ index ];
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ > & qpSmallList< _type_, _inlineCapacity_ >::operator=( const qpSmallList & other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	Clear();
+	Reserve( other.m_length );
+	CopyConstructItems( other.m_data, other.m_length );
+	return *this;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+qpSmallList< _type_, _inlineCapacity_ > & qpSmallList< _type_, _inlineCapacity_ >::operator=( qpSmallList && other ) noexcept {
+	if ( this == &other ) {
+		return *this;
+	}
+	Clear();
+	FreeHeapData();
+	m_allocator = other.m_allocator;
+	TakeItems( other );
+	return *this;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::Grow( const uint64 minCapacity ) {
+	SetCapacity( qpMath::Max( m_capacity * 2, minCapacity ) );
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::SetCapacity( const uint64 capacity ) {
+	QP_ASSERT_MSG( capacity >= m_length, "Can't set the capacity of a list below its length." );
+	if ( capacity <= _inlineCapacity_ ) {
+		if ( !IsInline() ) {
+			_type_ * heapData = m_data;
+			const uint64 heapCapacity = m_capacity;
+			MoveItemsTo( InlineData() );
+			m_allocator->Free( heapData, heapCapacity * sizeof( _type_ ) );
+			m_data = InlineData();
+			m_capacity = _inlineCapacity_;
+		}
+		return;
+	}
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		if ( !IsInline() ) {
+			_type_ * newData = static_cast< _type_ * >( m_allocator->Reallocate( m_data, m_capacity * sizeof( _type_ ), capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+			QP_ASSERT_RELEASE_MSG( newData != NULL, "List allocator is out of memory." );
+			m_data = newData;
+			m_capacity = capacity;
+			return;
+		}
+	}
+	_type_ * newData = static_cast< _type_ * >( m_allocator->Allocate( capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+	QP_ASSERT_RELEASE_MSG( newData != NULL, "List allocator is out of memory." );
+	MoveItemsTo( newData );
+	FreeHeapData();
+	m_data = newData;
+	m_capacity = capacity;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::MoveItemsTo( _type_ * data ) {
+	if constexpr ( IsTriviallyRelocatable< _type_ > ) {
+		if ( m_length > 0 ) {
+			memcpy( static_cast< void * >( data ), m_data, m_length * sizeof( _type_ ) );
+		}
+	} else {
+		for ( uint64 index = 0; index < m_length; ++index ) {
+			new ( &data[ index ] ) _type_( qpMove( m_data[ index ] ) );
+			m_data[ index ].~_type_();
+		}
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::CopyConstructItems( const _type_ * items, const uint64 count ) {
+	QP_ASSERT_MSG( m_length + count <= m_capacity, "Copying more items than the list has room for." );
+	if constexpr ( IsTrivialToCopy< _type_ > ) {
+		if ( count > 0 ) {
+			memcpy( static_cast< void * >( &m_data[ m_length ] ), items, count * sizeof( _type_ ) );
+		}
+	} else {
+		for ( uint64 index = 0; index < count; ++index ) {
+			new ( &m_data[ m_length + index ] ) _type_( items[ index ] );
+		}
+	}
+	m_length += count;
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::DestroyItems( const uint64 from, const uint64 to ) {
+	if constexpr ( !std::is_trivially_destructible_v< _type_ > ) {
+		for ( uint64 index = from; index < to; ++index ) {
+			m_data[ index ].~_type_();
+		}
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::FreeHeapData() {
+	if ( !IsInline() ) {
+		m_allocator->Free( m_data, m_capacity * sizeof( _type_ ) );
+		m_data = InlineData();
+		m_capacity = _inlineCapacity_;
+	}
+}
+
+template< typename _type_, int _inlineCapacity_ >
+void qpSmallList< _type_, _inlineCapacity_ >::TakeItems( qpSmallList & other ) {
+	QP_ASSERT_MSG( IsInline() && IsEmpty(), "Taking items into a list that already has items." );
+	if ( other.IsInline() ) {
+		m_length = other.m_length;
+		other.MoveItemsTo( InlineData() );
+	} else {
+		m_data = other.m_data;
+		m_capacity = other.m_capacity;
+		m_length = other.m_length;
+		other.m_data = other.InlineData();
+		other.m_capacity = _inlineCapacity_;
+	}
+	other.m_length = 0;
+}
@@ -0,0 +1,279 @@
+#pragma once
+#include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/allocation/qp_memory_tracking.h"
+#include "qp/common/core/qp_macros.h"
+#include "qp/common/core/qp_sys_calls.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/math/qp_math.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <iterator>
+#include <new>
+
+// List that reserves address space for maxLength items up front and only commits memory as it grows.
+// Growing never moves the items, so pointers to items stay valid until they are removed, and never needs
+// memory for two copies of the list. Use it for big tables and buffers that grow over time, the address
+// space is cheap but the list can't grow past maxLength.
+template< typename _type_ >
+class qpVirtualList {
+public:
+	QP_FORWARD_ITERATOR( Iterator, qpVirtualList, _type_ )
+
+	// committed memory is counted towards category.
+	explicit qpVirtualList( const uint64 maxLength, const memoryCategory_t category = memoryCategory_t::GENERAL );
+	qpVirtualList( const qpVirtualList & other ) = delete;
+	qpVirtualList( qpVirtualList && other ) noexcept;
+	~qpVirtualList();
+
+	void Push( const _type_ & item );
+	void Push( _type_ && item );
+	template < typename ... _args_ >
+	_type_ & Emplace( _args_ &&... args );
+	void Pop();
+	// moves the last item into the removed item's place.
+	void RemoveIndexFast( const uint64 index );
+
+	_type_ & First();
+	_type_ & Last();
+	const _type_ & First() const;
+	const _type_ & Last() const;
+
+	_type_ * Data() const { return m_data; }
+
+	// commits memory for at least capacity items.
+	void Reserve( const uint64 capacity );
+	void Resize( const uint64 length );
+	void Clear();
+	// gives memory that isn't used by any item back to the os, the address space stays reserved.
+	void ShrinkToFit();
+
+	uint64 Length() const { return m_length; }
+	uint64 Capacity() const { return m_capacity; }
+	uint64 MaxLength() const { return m_maxLength; }
+	bool IsEmpty() const { return m_length == 0; }
+
+	_type_ & operator[]( const uint64 index );
+	const _type_ & operator[]( const uint64 index ) const;
+
+	qpVirtualList & operator=( const qpVirtualList & other ) = delete;
+	qpVirtualList & operator=( qpVirtualList && other ) noexcept;
+
+	QP_ITERATORS( Iterator, Iterator( m_data ), Iterator( m_data + m_length ) )
+private:
+	enum : uint64 {
+		// memory is committed in steps of at least this many bytes so growing one item at a time doesn't hit the os every time.
+		MIN_COMMIT_SIZE = 64 * 1024
+	};
+	_type_ * m_data = NULL;
+	uint64 m_length = 0;
+	uint64 m_capacity = 0;
+	uint64 m_maxLength = 0;
+	uint64 m_committedBytes = 0;
+	uint64 m_reservedBytes = 0;
+	memoryCategory_t m_category = memoryCategory_t::GENERAL;
+
+	void Commit( const uint64 bytes );
+	void Decommit( const uint64 bytes );
+	void SetCommittedBytes( const uint64 bytes );
+	void Release();
+};
+
+template< typename _type_ >
+qpVirtualList< _type_ >::qpVirtualList( const uint64 maxLength, const memoryCategory_t category ) : m_maxLength( maxLength ), m_category( category ) {
+	QP_COMPILE_TIME_ASSERT_MSG( alignof( _type_ ) <= 4096, "Virtual lists can't hold types aligned to more than a page." );
+	m_reservedBytes = qpAllocationUtil::AlignUp( qpMath::Max( maxLength * sizeof( _type_ ), 1ull ), Sys_PageSize() );
+	m_data = static_cast< _type_ * >( Sys_ReserveMemory( m_reservedBytes ) );
+	if ( m_data == NULL ) {
+		throw std::bad_alloc();
+	}
+}
+
+template< typename _type_ >
+qpVirtualList< _type_ >::qpVirtualList( qpVirtualList && other ) noexcept
+	: m_data( other.m_data ), m_length( other.m_length ), m_capacity( other.m_capacity ), m_maxLength( other.m_maxLength ),
+	m_committedBytes( other.m_committedBytes ), m_reservedBytes( other.m_reservedBytes ), m_category( other.m_category ) {
+	other.m_data = NULL;
+	other.m_length = 0;
+	other.m_capacity = 0;
+	other.m_maxLength = 0;
+	other.m_committedBytes = 0;
+	other.m_reservedBytes = 0;
+}
+
+template< typename _type_ >
+qpVirtualList< _type_ >::~qpVirtualList() {
+	Release();
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Push( const _type_ & item ) {
+	Emplace( item );
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Push( _type_ && item ) {
+	Emplace( qpMove( item ) );
+}
+
+template< typename _type_ >
+template< typename ... _args_ >
+_type_ & qpVirtualList< _type_ >::Emplace( _args_ &&... args ) {
+	if ( m_length == m_capacity ) {
+		Reserve( m_length + 1 );
+	}
+	_type_ * item = new ( &m_data[ m_length ] ) _type_( qpForward< _args_ >( args )... );
+	++m_length;
+	return *item;
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Pop() {
+	if ( m_length > 0 ) {
+		m_data[ --m_length ].~_type_();
+	}
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::RemoveIndexFast( const uint64 index ) {
+	QP_ASSERT_MSG( index < m_length, "Index is out of bounds." );
+	if ( index != m_length - 1 ) {
+		m_data[ index ] = qpMove( m_data[ m_length - 1 ] );
+	}
+	Pop();
+}
+
+template< typename _type_ >
+_type_ & qpVirtualList< _type_ >::First() {
+	QP_ASSERT_MSG( m_length != 0, "Accessing first element but the list is empty." );
+	return m_data[ 0 ];
+}
+
+template< typename _type_ >
+_type_ & qpVirtualList< _type_ >::Last() {
+	QP_ASSERT_MSG( m_length != 0, "Accessing last element but the list is empty." );
+	return m_data[ m_length - 1 ];
+}
+
+template< typename _type_ >
+const _type_ & qpVirtualList< _type_ >::First() const {
+	QP_ASSERT_MSG( m_length != 0, "Accessing first element but the list is empty." );
+	return m_data[ 0 ];
+}
+
+template< typename _type_ >
+const _type_ & qpVirtualList< _type_ >::Last() const {
+	QP_ASSERT_MSG( m_length != 0, "Accessing last element but the list is empty." );
+	return m_data[ m_length - 1 ];
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Reserve( const uint64 capacity ) {
+	if ( capacity <= m_capacity ) {
+		return;
+	}
+	QP_ASSERT_RELEASE_MSG( capacity <= m_maxLength, "Virtual list has grown past the length it reserved memory for." );
+	const uint64 requiredBytes = qpAllocationUtil::AlignUp( capacity * sizeof( _type_ ), Sys_PageSize() );
+	const uint64 commitBytes = qpMath::Min( qpMath::Max( requiredBytes, m_committedBytes + MIN_COMMIT_SIZE ), m_reservedBytes );
+	Commit( commitBytes );
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Resize( const uint64 length ) {
+	Reserve( length );
+	while ( m_length > length ) {
+		Pop();
+	}
+	while ( m_length < length ) {
+		Emplace();
+	}
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Clear() {
+	while ( m_length > 0 ) {
+		Pop();
+	}
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::ShrinkToFit() {
+	Decommit( qpAllocationUtil::AlignUp( m_length * sizeof( _type_ ), Sys_PageSize() ) );
+}
+
+template< typename _type_ >
+_type_ & qpVirtualList< _type_ >::operator[]( const uint64 index ) {
+	QP_ASSERT_MSG( index < m_length, "Index is out of bounds." );
+	return m_data[ index ];
+}
+
+template< typename _type_ >
+const _type_ & qpVirtualList< _type_ >::operator[]( const uint64 index ) const {
+	QP_ASSERT_MSG( index < m_length, "Index is out of bounds." );
+	return m_data[ index ];
+}
+
+template< typename _type_ >
+qpVirtualList< _type_ > & qpVirtualList< _type_ >::operator=( qpVirtualList && other ) noexcept {
+	if ( this == &other ) {
+		return *this;
+	}
+	Release();
+	m_data = other.m_data;
+	m_length = other.m_length;
+	m_capacity = other.m_capacity;
+	m_maxLength = other.m_maxLength;
+	m_committedBytes = other.m_committedBytes;
+	m_reservedBytes = other.m_reservedBytes;
+	m_category = other.m_category;
+	other.m_data = NULL;
+	other.m_length = 0;
+	other.m_capacity = 0;
+	other.m_maxLength = 0;
+	other.m_committedBytes = 0;
+	other.m_reservedBytes = 0;
+	return *this;
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Commit( const uint64 bytes ) {
+	if ( !Sys_CommitMemory( reinterpret_cast< byte * >( m_data ) + m_committedBytes, bytes - m_committedBytes ) ) {
+		throw std::bad_alloc();
+	}
+	SetCommittedBytes( bytes );
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Decommit( const uint64 bytes ) {
+	if ( bytes >= m_committedBytes ) {
+		return;
+	}
+	Sys_DecommitMemory( reinterpret_cast< byte * >( m_data ) + bytes, m_committedBytes - bytes );
+	SetCommittedBytes( bytes );
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::SetCommittedBytes( const uint64 bytes ) {
+#if defined( QP_MEMORY_TRACKING )
+	// the committed memory is tracked as a single allocation that changes size.
+	if ( m_committedBytes != 0 ) {
+		qpMemoryTracking::OnFree( m_category, m_committedBytes );
+	}
+	if ( bytes != 0 ) {
+		qpMemoryTracking::OnAllocate( m_category, bytes );
+	}
+#endif
+	m_committedBytes = bytes;
+	m_capacity = qpMath::Min( m_committedBytes / sizeof( _type_ ), m_maxLength );
+}
+
+template< typename _type_ >
+void qpVirtualList< _type_ >::Release() {
+	if ( m_data == NULL ) {
+		return;
+	}
+	Clear();
+	Decommit( 0 );
+	Sys_ReleaseMemory( m_data, m_reservedBytes );
+	m_data = NULL;
+	m_capacity = 0;
+	m_reservedBytes = 0;
+}
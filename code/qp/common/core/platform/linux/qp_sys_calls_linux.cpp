@@ -5,6 +5,7 @@
 #include "qp/common/core/qp_sys_calls.h"
 #include <cstring>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <cctype>
 
@@ -34,4 +35,27 @@ bool Sys_InitializeConsole() {
 	return true;
 }
 
+size_t Sys_PageSize() {
+	static const size_t pageSize = static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+	return pageSize;
+}
+
+void * Sys_ReserveMemory( const size_t size ) {
+	void * ptr = mmap( NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+	return ( ptr != MAP_FAILED ) ? ptr : NULL;
+}
+
+bool Sys_CommitMemory( void * ptr, const size_t size ) {
+	return mprotect( ptr, size, PROT_READ | PROT_WRITE ) == 0;
+}
+
+void Sys_DecommitMemory( void * ptr, const size_t size ) {
+	QP_DISCARD_RESULT madvise( ptr, size, MADV_DONTNEED );
+	QP_DISCARD_RESULT mprotect( ptr, size, PROT_NONE );
+}
+
+void Sys_ReleaseMemory( void * ptr, const size_t size ) {
+	QP_DISCARD_RESULT munmap( ptr, size );
+}
+
 #endif
@@ -120,4 +120,30 @@ bool Sys_InitializeConsole() {
 	return true;
 }
 
+size_t Sys_PageSize() {
+	static const size_t pageSize = [] () {
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo( &systemInfo );
+		return static_cast< size_t >( systemInfo.dwPageSize );
+	}();
+	return pageSize;
+}
+
+void * Sys_ReserveMemory( const size_t size ) {
+	return VirtualAlloc( NULL, size, MEM_RESERVE, PAGE_NOACCESS );
+}
+
+bool Sys_CommitMemory( void * ptr, const size_t size ) {
+	return VirtualAlloc( ptr, size, MEM_COMMIT, PAGE_READWRITE ) != NULL;
+}
+
+void Sys_DecommitMemory( void * ptr, const size_t size ) {
+	QP_DISCARD_RESULT VirtualFree( ptr, size, MEM_DECOMMIT );
+}
+
+void Sys_ReleaseMemory( void * ptr, const size_t size ) {
+	( void )size;
+	QP_DISCARD_RESULT VirtualFree( ptr, 0, MEM_RELEASE );
+}
+
 #endif
@@ -9,7 +9,7 @@
 #define QP_INTRUSIVE_REF_COUNTER \
 public: \
 	void QP_INTRUSIVE_INCREMENT_REF() const { ++QP_INTRUSIVE_COUNTER_MEMBER; } \
-	void QP_INTRUSIVE_DECREMENT_REF() const { --QP_INTRUSIVE_COUNTER_MEMBER; } \
+	uint32 QP_INTRUSIVE_DECREMENT_REF() const { return --QP_INTRUSIVE_COUNTER_MEMBER; } \
 	uint32 QP_INTRUSIVE_GET_COUNTER() const { return QP_INTRUSIVE_COUNTER_MEMBER.load(); } \
 private: \
 	mutable atomicUInt32_t QP_INTRUSIVE_COUNTER_MEMBER = 0u
@@ -197,9 +197,8 @@ void qpIntrusiveRefPtr< _type_ >::IncrementRef() {
 template< typename _type_ > requires qpHasIntrusiveRefCounter< _type_ >
 void qpIntrusiveRefPtr< _type_ >::DecrementRef() {
 	if ( m_ptr ) {
-		m_ptr->QP_INTRUSIVE_DECREMENT_REF();
-
-		if ( m_ptr->QP_INTRUSIVE_GET_COUNTER() == 0 ) {
+		// use the value returned by the decrement, another thread could release its reference in between.
+		if ( m_ptr->QP_INTRUSIVE_DECREMENT_REF() == 0 ) {
 			delete m_ptr;
 			m_ptr = NULL;
 		}
@@ -21,6 +21,11 @@
 #define QP_NO_DISCARD [[ nodiscard ]]
 #define QP_INLINE inline
 #define QP_FORCE_INLINE __forceinline
+#if defined( _MSC_VER )
+#define QP_NO_INLINE __declspec( noinline )
+#else
+#define QP_NO_INLINE __attribute__( ( noinline ) )
+#endif
 
 #define QP_ARRAY_LENGTH( x ) ( sizeof( x ) / sizeof( x[ 0 ] ) )
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdio>
 
 extern FILE *	Sys_GetConsoleOut();
@@ -8,4 +9,14 @@ extern void		Sys_OutputDebugString( const char * fmt, ... );
 extern bool		Sys_DebuggerPresent();
 extern void		Sys_DebugBreak();
 extern bool		Sys_CreateDirectory( const char * path );
-extern bool		Sys_InitializeConsole();
\ No newline at end of file
+extern bool		Sys_InitializeConsole();
+
+// virtual memory, sizes and addresses have to be multiples of the page size.
+extern size_t	Sys_PageSize();
+// reserves address space without any memory behind it, returns NULL on failure.
+extern void *	Sys_ReserveMemory( const size_t size );
+extern bool		Sys_CommitMemory( void * ptr, const size_t size );
+// gives the memory back to the os but keeps the address space reserved.
+extern void		Sys_DecommitMemory( void * ptr, const size_t size );
+// releases the whole range, ptr and size have to be what was reserved.
+extern void		Sys_ReleaseMemory( void * ptr, const size_t size );
\ No newline at end of file
@@ -107,3 +107,8 @@ QP_INLINE constexpr bool IsBaseOf = __is_base_of( _base_, _derived_ );
 
 template < typename _type_ >
 QP_INLINE constexpr bool IsTrivialToCopy = __is_trivially_copyable( _type_ );
+
+// types that can be moved to new memory with memcpy instead of a move construct and destroy.
+// trivially copyable types always are, types that only own memory through a pointer can opt in by specializing it.
+template < typename _type_ >
+QP_INLINE constexpr bool IsTriviallyRelocatable = IsTrivialToCopy< _type_ >;
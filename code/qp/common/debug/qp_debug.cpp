@@ -1,5 +1,6 @@
 #include "engine.pch.h"
 #include "qp_debug.h"
+#include "common/allocation/qp_scratch_allocator.h"
 #include "common/math/qp_math.h"
 #include "common/time/qp_clock.h"
 #include "common/threads/qp_thread_util.h"
@@ -35,6 +36,8 @@ namespace qpDebug {
 	namespace {
 		using atomicDebugCategory_t = atomic_t< category_t >;
 		atomicDebugCategory_t s_debugCategory = category_t::ALL;
+		// messages are formatted in scratch memory so printing doesn't need a big buffer on small fiber stacks.
+		const size_t s_printBufferSize = 16 * 1024;
 
 		const qpTimePoint s_programStartTime = qpClock::Now();
 		struct logFileData_t {
@@ -115,13 +118,18 @@ namespace qpDebug {
 		if ( !HasOpenedLogFile( logFileData ) ) {
 			TryOpenLogFile( logFileData );
 		}
-		char buffer[ 4096 ] {};
-		size_t prefixLength = GetPrintPrefix( category, buffer, sizeof( buffer ) );
+		qpScratchScope scratch;
+		char * buffer = static_cast< char * >( scratch.GetAllocator().Allocate( s_printBufferSize, 1 ) );
+		buffer[ 0 ] = '\0';
+		size_t prefixLength = GetPrintPrefix( category, buffer, s_printBufferSize );
 		const qpTimePoint timeSinceStart = qpClock::Now() - s_programStartTime;
 		const int timeSeconds = timeSinceStart.AsSeconds().GetI32();
-		const int bufferPrintLength = vsnprintf( buffer + prefixLength, sizeof( buffer ) - prefixLength - 1, format, args );
+		const int bufferPrintLength = vsnprintf( buffer + prefixLength, s_printBufferSize - prefixLength - 1, format, args );
 		if ( ( category & category_t::PRINT ) != category_t::PRINT ) {
-			buffer[ qpMath::Min( bufferPrintLength + prefixLength, sizeof( buffer ) - 1 ) ] = '\n';
+			// the buffer isn't cleared so the newline needs a terminator after it.
+			const size_t newlineIndex = qpMath::Min( bufferPrintLength + prefixLength, s_printBufferSize - 2 );
+			buffer[ newlineIndex ] = '\n';
+			buffer[ newlineIndex + 1 ] = '\0';
 		}
 		QP_DISCARD_RESULT fprintf( stream, "[%d] %s%s%s", timeSeconds, color != NULL ? color : QP_CONSOLE_DEFAULT_COLOR, buffer, QP_CONSOLE_DEFAULT_COLOR );
 		
@@ -129,6 +137,7 @@ namespace qpDebug {
 			QP_DISCARD_RESULT fprintf( logFileData.logFile, "[%d] %s", timeSeconds, buffer );
 		}
 		Sys_OutputDebugString( "[%d] %s", timeSeconds, buffer );
+		scratch.GetAllocator().Free( buffer, s_printBufferSize );
 	}
 
 	void CriticalError ( const char * format, ... ) {
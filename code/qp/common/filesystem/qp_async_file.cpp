@@ -0,0 +1,7 @@
+#include "engine.pch.h"
+#include "qp_async_file.h"
+
+qpTask< qpList< byte > > qpReadFileAsync( qpThreadPool & threadPool, const qpFilePath filePath ) {
+	co_await threadPool.Schedule();
+	co_return qpReadFile( filePath );
+}
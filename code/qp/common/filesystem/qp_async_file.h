@@ -0,0 +1,8 @@
+#pragma once
+#include "qp_file.h"
+#include "qp/common/jobs/qp_task.h"
+#include "qp/common/threads/qp_thread_pool.h"
+
+// reads the whole file on one of the pool's workers, the awaiting coroutine continues on that worker.
+// the path is taken by value since the coroutine can outlive the caller's arguments.
+qpTask< qpList< byte > > qpReadFileAsync( qpThreadPool & threadPool, const qpFilePath filePath );
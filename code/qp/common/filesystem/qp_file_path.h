@@ -33,15 +33,15 @@ qpFilePathBase<_type_>::qpFilePathBase( const _type_ * path ) {
 
 template< typename _type_ >
 bool qpFilePathBase<_type_>::GetExtension( stringType_t & outExtension ) const {
-	const int bufferLength = 256;
-	_type_ buffer[ bufferLength ];
-	int extensionLength = 0;
-	if ( GetExtension( buffer, bufferLength, extensionLength ) ) {
-		outExtension.Assign( buffer, extensionLength );
-		return true;
+	// assigned straight from the path so no temporary buffer is needed.
+	auto extIt = m_path.ReverseFind( '.' );
+	if ( extIt == m_path.End() ) {
+		outExtension.Clear();
+		return false;
 	}
-	QP_ASSERT( bufferLength <= QP_ARRAY_LENGTH( buffer ) );
-	return false;
+	const _type_ * ext = *extIt;
+	outExtension.Assign( ext, qpStrLen( ext ) );
+	return true;
 }
 
 template< typename _type_ >
@@ -54,7 +54,9 @@ bool qpFilePathBase<_type_>::GetExtension( _type_ * inOutBuffer, const int buffe
 
 	auto extIt = m_path.ReverseFind( '.' );
 	if ( extIt == m_path.End() ) {
-		inOutBuffer[ 0 ] = CharTraits< _type_ >::NIL_CHAR;
+		if ( inOutBuffer != NULL ) {
+			inOutBuffer[ 0 ] = CharTraits< _type_ >::NIL_CHAR;
+		}
 		outExtensionLength = 0;
 		return false;
 	}
@@ -0,0 +1,305 @@
+#include "engine.pch.h"
+#include "qp_job_system.h"
+#include "qp/common/threads/qp_thread_util.h"
+
+namespace {
+	const uint64 s_fiberStackSizes[ static_cast< int >( jobStackSize_t::COUNT ) ] = {
+		64 * 1024,
+		256 * 1024,
+		1024 * 1024
+	};
+
+	struct fiberThreadState_t {
+		qpFiber * currentFiber = NULL;
+		void * currentSlot = NULL;
+	};
+
+	// fibers can be resumed on another thread so thread locals are only reached through functions that can't be inlined,
+	// otherwise the compiler is free to reuse the address it looked up before the switch.
+	QP_NO_INLINE fiberThreadState_t & GetFiberThreadState() {
+		static thread_local fiberThreadState_t fiberThreadState;
+		return fiberThreadState;
+	}
+
+	QP_NO_INLINE qpFiber & GetThreadFiber() {
+		static thread_local qpFiber threadFiber;
+		return threadFiber;
+	}
+
+	uint32 FreeListIndex( const uint64 head ) { return static_cast< uint32 >( head & 0xFFFFFFFF ); }
+	uint64 FreeListHead( const uint64 oldHead, const uint32 index ) { return ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | index; }
+}
+
+qpJobSystem::qpJobSystem( qpThreadPool & threadPool, const bool useFibers ) : m_threadPool( threadPool ), m_useFibers( useFibers ) {
+	for ( int index = MAX_JOBS - 1; index >= 0; --index ) {
+		FreeJob( static_cast< uint32 >( index ) );
+	}
+}
+
+qpJobSystem::~qpJobSystem() {
+	QP_ASSERT_MSG( m_numLiveJobs.load() == 0, "Job system destroyed with jobs that haven't finished." );
+	for ( fiberSlot_t * slot : m_fibers ) {
+		delete slot->fiber;
+		delete slot;
+	}
+}
+
+jobHandle_t qpJobSystem::CreateJob( jobFunctor_t && func, const jobStackSize_t stackSize, const jobPriority_t priority ) {
+	const uint32 index = AllocateJob();
+	if ( index == INVALID_JOB_INDEX ) {
+		qpDebug::Error( "JobSystem: Out of jobs, %d jobs are alive.", MAX_JOBS );
+		return jobHandle_t {};
+	}
+
+	storedJob_t & storedJob = m_storedJobs[ index ];
+	job_t & job = storedJob.job;
+	{
+		std::scoped_lock lock( job.mutex );
+		job.func = qpMove( func );
+		job.dependents.Clear();
+		job.waiters = NULL;
+		job.stackSize = stackSize;
+		job.priority = priority;
+		job.finished = false;
+	}
+	job.numPendingDependencies.store( 1 );
+	storedJob.flags.store( 0 );
+	m_numLiveJobs.fetch_add( 1 );
+
+	jobHandle_t handle;
+	handle.index = index;
+	handle.flags = jobHandle_t::FLAG_VALID;
+	handle.version = storedJob.version.load();
+	return handle;
+}
+
+bool qpJobSystem::LinkJobs( const jobHandle_t head, const jobHandle_t tail ) {
+	storedJob_t * tailJob = GetStoredJob( tail );
+	if ( !QP_VERIFY_MSG( tailJob != NULL, "Linking to a job that has already finished." ) ) {
+		return false;
+	}
+	if ( !QP_VERIFY_MSG( ( tailJob->flags.load() & JOB_FLAG_KICKED ) == 0, "Can't add dependencies to a job that has already been kicked." ) ) {
+		return false;
+	}
+
+	storedJob_t * headJob = GetStoredJob( head );
+	if ( headJob == NULL ) {
+		// head has already finished so there is nothing to wait for.
+		return true;
+	}
+
+	std::scoped_lock lock( headJob->job.mutex );
+	// the version is checked again since head could have finished and been recycled since it was looked up.
+	if ( headJob->job.finished || ( headJob->version.load() != head.version ) ) {
+		return true;
+	}
+	headJob->job.dependents.Push( tail.index );
+	tailJob->job.numPendingDependencies.fetch_add( 1 );
+	return true;
+}
+
+bool qpJobSystem::Kick( const jobHandle_t handle ) {
+	storedJob_t * storedJob = GetStoredJob( handle );
+	if ( !QP_VERIFY_MSG( storedJob != NULL, "Kicking a job that has already finished." ) ) {
+		return false;
+	}
+	const uint16 previousFlags = storedJob->flags.fetch_or( JOB_FLAG_KICKED );
+	if ( !QP_VERIFY_MSG( ( previousFlags & JOB_FLAG_KICKED ) == 0, "Job has already been kicked." ) ) {
+		return false;
+	}
+	ReleaseDependency( handle.index );
+	return true;
+}
+
+void qpJobSystem::Wait( const jobHandle_t handle ) {
+	const storedJob_t * storedJob = GetStoredJob( handle );
+	if ( storedJob == NULL ) {
+		return;
+	}
+	QP_ASSERT_MSG( ( storedJob->flags.load() & JOB_FLAG_KICKED ) != 0, "Waiting on a job that hasn't been kicked will never finish." );
+
+	fiberSlot_t * slot = static_cast< fiberSlot_t * >( GetFiberThreadState().currentSlot );
+	if ( ( slot != NULL ) && ( slot->jobSystem == this ) ) {
+		SuspendFiber( slot, handle );
+		QP_ASSERT_MSG( IsFinished( handle ), "Fiber resumed before the job it waited on finished." );
+		return;
+	}
+
+	while ( !IsFinished( handle ) ) {
+		if ( !m_threadPool.TryRunPendingJob() ) {
+			qpThreadUtil::YieldThread();
+		}
+	}
+}
+
+bool qpJobSystem::IsFinished( const jobHandle_t handle ) const {
+	if ( !handle.IsValid() || ( handle.index >= MAX_JOBS ) ) {
+		return true;
+	}
+	return m_storedJobs[ handle.index ].version.load() != handle.version;
+}
+
+qpJobSystem::storedJob_t * qpJobSystem::GetStoredJob( const jobHandle_t handle ) {
+	if ( IsFinished( handle ) ) {
+		return NULL;
+	}
+	return &m_storedJobs[ handle.index ];
+}
+
+uint32 qpJobSystem::AllocateJob() {
+	uint64 head = m_freeListHead.load();
+	while ( FreeListIndex( head ) != INVALID_JOB_INDEX ) {
+		const uint32 index = FreeListIndex( head );
+		const uint32 next = m_storedJobs[ index ].next.load();
+		if ( m_freeListHead.compare_exchange_weak( head, FreeListHead( head, next ) ) ) {
+			return index;
+		}
+	}
+	return INVALID_JOB_INDEX;
+}
+
+void qpJobSystem::FreeJob( const uint32 index ) {
+	uint64 head = m_freeListHead.load();
+	do {
+		m_storedJobs[ index ].next.store( FreeListIndex( head ) );
+	} while ( !m_freeListHead.compare_exchange_weak( head, FreeListHead( head, index ) ) );
+}
+
+void qpJobSystem::ReleaseDependency( const uint32 index ) {
+	job_t & job = m_storedJobs[ index ].job;
+	if ( job.numPendingDependencies.fetch_sub( 1 ) == 1 ) {
+		m_threadPool.QueueJob( [ this, index ]() { RunJob( index ); }, job.priority );
+	}
+}
+
+void qpJobSystem::RunJob( const uint32 index ) {
+	if ( !m_useFibers ) {
+		ExecuteJob( index );
+		return;
+	}
+
+	fiberSlot_t * slot = AcquireFiber( m_storedJobs[ index ].job.stackSize );
+	slot->jobIndex = index;
+	slot->state = fiberState_t::RUNNING;
+	SwitchToFiber( slot );
+}
+
+void qpJobSystem::ExecuteJob( const uint32 index ) {
+	storedJob_t & storedJob = m_storedJobs[ index ];
+	job_t & job = storedJob.job;
+	job.func();
+	// release anything captured by the job right away instead of when the job is reused.
+	job.func = jobFunctor_t();
+
+	qpSmallList< uint32, NUM_INLINE_JOB_DEPENDENCIES > dependents;
+	fiberSlot_t * waiters = NULL;
+	{
+		std::scoped_lock lock( job.mutex );
+		job.finished = true;
+		dependents = qpMove( job.dependents );
+		waiters = job.waiters;
+		job.waiters = NULL;
+		// invalidates every handle to this job which is what waiters are looking for.
+		storedJob.version.fetch_add( 1 );
+	}
+
+	for ( const uint32 dependent : dependents ) {
+		ReleaseDependency( dependent );
+	}
+	while ( waiters != NULL ) {
+		fiberSlot_t * next = waiters->nextWaiter;
+		waiters->nextWaiter = NULL;
+		ResumeFiber( waiters );
+		waiters = next;
+	}
+
+	m_numLiveJobs.fetch_sub( 1 );
+	FreeJob( index );
+}
+
+qpJobSystem::fiberSlot_t * qpJobSystem::AcquireFiber( const jobStackSize_t stackSize ) {
+	std::scoped_lock lock( m_fiberMutex );
+	qpList< fiberSlot_t * > & freeFibers = m_freeFibers[ static_cast< int >( stackSize ) ];
+	if ( !freeFibers.IsEmpty() ) {
+		fiberSlot_t * slot = freeFibers.Last();
+		freeFibers.Pop();
+		return slot;
+	}
+
+	fiberSlot_t * slot = new fiberSlot_t();
+	slot->jobSystem = this;
+	slot->stackSize = stackSize;
+	slot->fiber = new qpFiber( s_fiberStackSizes[ static_cast< int >( stackSize ) ], &qpJobSystem::FiberMain, slot );
+	m_fibers.Push( slot );
+	return slot;
+}
+
+void qpJobSystem::ReleaseFiber( fiberSlot_t * slot ) {
+	std::scoped_lock lock( m_fiberMutex );
+	m_freeFibers[ static_cast< int >( slot->stackSize ) ].Push( slot );
+}
+
+void qpJobSystem::SwitchToFiber( fiberSlot_t * slot ) {
+	fiberThreadState_t & threadState = GetFiberThreadState();
+	qpFiber * currentFiber = ( threadState.currentFiber != NULL ) ? threadState.currentFiber : &GetThreadFiber();
+	void * currentSlot = threadState.currentSlot;
+
+	slot->returnFiber = currentFiber;
+	threadState.currentFiber = slot->fiber;
+	threadState.currentSlot = slot;
+	currentFiber->SwitchTo( *slot->fiber );
+
+	// the fiber has switched back, either it finished its job or it's waiting for another one.
+	fiberThreadState_t & returnedThreadState = GetFiberThreadState();
+	returnedThreadState.currentFiber = currentFiber;
+	returnedThreadState.currentSlot = currentSlot;
+
+	// registering the fiber has to wait until here, before the switch another thread could have resumed it while it was still running.
+	switch ( slot->state ) {
+		case fiberState_t::FINISHED:
+			ReleaseFiber( slot );
+			break;
+		case fiberState_t::WAITING:
+			AddWaiter( slot );
+			break;
+		default:
+			QP_ASSERT_MSG( false, "Fiber switched back while still running a job." );
+			break;
+	}
+}
+
+void qpJobSystem::SuspendFiber( fiberSlot_t * slot, const jobHandle_t handle ) {
+	slot->waitHandle = handle;
+	slot->state = fiberState_t::WAITING;
+	slot->fiber->SwitchTo( *slot->returnFiber );
+}
+
+void qpJobSystem::AddWaiter( fiberSlot_t * slot ) {
+	job_t & job = m_storedJobs[ slot->waitHandle.index ].job;
+	{
+		std::scoped_lock lock( job.mutex );
+		if ( !job.finished && ( m_storedJobs[ slot->waitHandle.index ].version.load() == slot->waitHandle.version ) ) {
+			slot->nextWaiter = job.waiters;
+			job.waiters = slot;
+			return;
+		}
+	}
+	// finished while the fiber was switching out.
+	ResumeFiber( slot );
+}
+
+void qpJobSystem::ResumeFiber( fiberSlot_t * slot ) {
+	slot->state = fiberState_t::RUNNING;
+	// the job is still alive while its fiber is suspended so its priority can be read here.
+	m_threadPool.QueueJob( [ this, slot ]() { SwitchToFiber( slot ); }, m_storedJobs[ slot->jobIndex ].job.priority );
+}
+
+void qpJobSystem::FiberMain( void * userData ) {
+	fiberSlot_t * slot = static_cast< fiberSlot_t * >( userData );
+	while ( true ) {
+		slot->jobSystem->ExecuteJob( slot->jobIndex );
+		slot->state = fiberState_t::FINISHED;
+		// the return fiber is read after the job since the job could have been resumed on another thread.
+		slot->fiber->SwitchTo( *slot->returnFiber );
+	}
+}
@@ -1,34 +1,128 @@
 #pragma once
 #include "common/containers/qp_array.h"
-#include "common/containers/qp_static_list.h"
+#include "common/containers/qp_list.h"
+#include "common/containers/qp_small_list.h"
+#include "qp/common/threads/qp_fiber.h"
 #include "qp/common/threads/qp_thread_pool.h"
+#include <mutex>
 
 struct jobHandle_t {
-	uint32 index;
-	uint16 flags;
-	uint16 version;
+	enum : uint16 {
+		FLAG_VALID = 1 << 0
+	};
+	uint32 index = 0;
+	uint16 flags = 0;
+	uint16 version = 0;
+
+	bool IsValid() const { return ( flags & FLAG_VALID ) != 0; }
+};
+
+// stack a job gets when the job system runs jobs on fibers.
+enum class jobStackSize_t {
+	SMALL,
+	MEDIUM,
+	LARGE,
+	COUNT
 };
 
+// Schedules jobs on a thread pool once all the jobs they depend on have finished.
+// Jobs are created, linked together and then kicked. A job is recycled as soon as it has finished
+// which bumps its version, so any handle still pointing at it is treated as finished.
+// With fibers enabled every job runs on its own fiber and waiting inside a job suspends the fiber
+// instead of the worker thread, the job is resumed on whichever worker is free once the job it waits on is done.
 class qpJobSystem {
 public:
+	using jobFunctor_t = qpThreadPool::threadJobFunctor_t;
 	enum : int16 {
-		MAX_JOB_DEPENDENCIES = 4,
+		// dependents a job keeps without allocating, jobs can have any number of dependents.
+		NUM_INLINE_JOB_DEPENDENCIES = 4,
 		MAX_JOBS = 1024
 	};
 
-	void LinkJobs( const jobHandle_t head, const jobHandle_t tail );
+	qpJobSystem( qpThreadPool & threadPool, const bool useFibers = false );
+	~qpJobSystem();
+
+	qpJobSystem( const qpJobSystem & other ) = delete;
+	qpJobSystem & operator=( const qpJobSystem & other ) = delete;
+
+	// creates a job that won't be scheduled until it has been kicked.
+	jobHandle_t CreateJob( jobFunctor_t && func, const jobStackSize_t stackSize = jobStackSize_t::SMALL, const jobPriority_t priority = jobPriority_t::NORMAL );
+	// tail won't run until head has finished. tail can't have been kicked yet.
+	bool LinkJobs( const jobHandle_t head, const jobHandle_t tail );
+	// schedules the job as soon as all of its dependencies have finished.
+	bool Kick( const jobHandle_t handle );
+	// suspends the calling job when running on a fiber, otherwise helps out running jobs until the job has finished.
+	// to wait for several jobs link them to an empty job and wait for that one.
+	void Wait( const jobHandle_t handle );
+
+	bool IsFinished( const jobHandle_t handle ) const;
+	bool UsesFibers() const { return m_useFibers; }
 private:
+	enum : uint16 {
+		JOB_FLAG_KICKED = 1 << 0
+	};
+	enum : uint32 {
+		INVALID_JOB_INDEX = 0xFFFFFFFF
+	};
+	enum class fiberState_t {
+		RUNNING,
+		WAITING,
+		FINISHED
+	};
+	struct fiberSlot_t {
+		qpJobSystem * jobSystem = NULL;
+		qpFiber * fiber = NULL;
+		// whatever switched to this fiber last, the fiber switches back to it when it suspends or finishes.
+		qpFiber * returnFiber = NULL;
+		jobStackSize_t stackSize = jobStackSize_t::SMALL;
+		fiberState_t state = fiberState_t::RUNNING;
+		uint32 jobIndex = INVALID_JOB_INDEX;
+		jobHandle_t waitHandle;
+		fiberSlot_t * nextWaiter = NULL;
+	};
 	struct job_t {
-		qpThreadPool::threadJobFunctor_t func;
-		qpStaticList< jobHandle_t, MAX_JOB_DEPENDENCIES > dependencies;
-		atomicBool_t finished = false;
+		jobFunctor_t func;
+		// jobs waiting on this job to finish.
+		qpSmallList< uint32, NUM_INLINE_JOB_DEPENDENCIES > dependents;
+		// fibers suspended in Wait on this job.
+		fiberSlot_t * waiters = NULL;
+		// the kick plus one for every job this job is waiting on.
+		atomicUInt32_t numPendingDependencies = 0;
+		jobStackSize_t stackSize = jobStackSize_t::SMALL;
+		jobPriority_t priority = jobPriority_t::NORMAL;
+		bool finished = false;
+		std::mutex mutex;
 	};
 	struct storedJob_t {
-		uint16 flags;
-		uint16 version;
-		uint32 next;
+		atomicUInt16_t flags = 0;
+		atomicUInt16_t version = 0;
+		atomicUInt32_t next = INVALID_JOB_INDEX;
 		job_t job;
 	};
+	qpThreadPool & m_threadPool;
 	qpArray< storedJob_t, MAX_JOBS > m_storedJobs;
-	qpStaticList< jobHandle_t, MAX_JOBS > m_jobs;
-};
\ No newline at end of file
+	// lock free free list, the upper 32 bits are a tag that's bumped on every change to avoid ABA.
+	atomicUInt64_t m_freeListHead = INVALID_JOB_INDEX;
+	atomicUInt32_t m_numLiveJobs = 0;
+
+	bool m_useFibers = false;
+	std::mutex m_fiberMutex;
+	qpList< fiberSlot_t * > m_freeFibers[ static_cast< int >( jobStackSize_t::COUNT ) ];
+	qpList< fiberSlot_t * > m_fibers;
+
+	storedJob_t * GetStoredJob( const jobHandle_t handle );
+	uint32 AllocateJob();
+	void FreeJob( const uint32 index );
+	void ReleaseDependency( const uint32 index );
+	void RunJob( const uint32 index );
+	void ExecuteJob( const uint32 index );
+
+	fiberSlot_t * AcquireFiber( const jobStackSize_t stackSize );
+	void ReleaseFiber( fiberSlot_t * slot );
+	void SwitchToFiber( fiberSlot_t * slot );
+	void SuspendFiber( fiberSlot_t * slot, const jobHandle_t handle );
+	void AddWaiter( fiberSlot_t * slot );
+	void ResumeFiber( fiberSlot_t * slot );
+
+	static void FiberMain( void * userData );
+};
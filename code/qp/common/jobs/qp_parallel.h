@@ -0,0 +1,195 @@
+#pragma once
+#include "common/containers/qp_array.h"
+#include "common/containers/qp_array_view.h"
+#include "common/containers/qp_list.h"
+#include "qp/common/core/qp_intrusive_ref_ptr.h"
+#include "qp/common/threads/qp_thread_pool.h"
+#include "qp/common/threads/qp_thread_util.h"
+
+// Splits [begin, end) over the thread pool. The calling thread works on the range as well and doesn't
+// return until every index has been processed. Chunks start out large and shrink as the range runs out
+// so that workers finishing early can still pick up work, chunks are never smaller than the grain size.
+
+namespace qpParallelInternal {
+	struct range_t {
+		int64 begin = 0;
+		int64 end = 0;
+	};
+
+	class qpParallelState {
+	public:
+		qpParallelState( const int64 begin, const int64 end, const int64 grainSize, const int64 numParticipants )
+			: m_end( end ), m_grainSize( qpMath::Max( grainSize, 1ll ) ), m_numParticipants( numParticipants ), m_numItems( end - begin ) {
+			m_next.store( begin );
+		}
+
+		bool ClaimRange( range_t & outRange ) {
+			int64 begin = m_next.load( std::memory_order_relaxed );
+			while ( begin < m_end ) {
+				const int64 remaining = m_end - begin;
+				const int64 chunkSize = qpMath::Min( remaining, qpMath::Max( m_grainSize, remaining / ( m_numParticipants * 2 ) ) );
+				if ( m_next.compare_exchange_weak( begin, begin + chunkSize, std::memory_order_relaxed ) ) {
+					outRange.begin = begin;
+					outRange.end = begin + chunkSize;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void CompleteRange( const range_t & range ) { m_numCompleted.fetch_add( range.end - range.begin, std::memory_order_release ); }
+		bool IsComplete() const { return m_numCompleted.load( std::memory_order_acquire ) == m_numItems; }
+		int64 NextParticipant() { return m_nextParticipant.fetch_add( 1, std::memory_order_relaxed ); }
+
+		QP_INTRUSIVE_REF_COUNTER;
+	private:
+		atomicInt64_t m_next = 0;
+		atomicInt64_t m_numCompleted = 0;
+		atomicInt64_t m_nextParticipant = 1;
+		const int64 m_end = 0;
+		const int64 m_grainSize = 1;
+		const int64 m_numParticipants = 1;
+		const int64 m_numItems = 0;
+	};
+
+	// calls runRange( participant, range ) until the whole range has been processed.
+	template < typename _runRange_ >
+	void Run( qpThreadPool & threadPool, const int64 begin, const int64 end, const int64 grainSize, const int64 numHelpers, const _runRange_ & runRange ) {
+		qpIntrusiveRefPtr< qpParallelState > state = qpCreateIntrusiveRef< qpParallelState >( begin, end, grainSize, numHelpers + 1 );
+
+		// the helpers keep the state alive since they can start after the caller has returned,
+		// by then there is nothing left to claim so they never touch runRange.
+		const _runRange_ * runRangePtr = &runRange;
+		qpParallelState * statePtr = state.Raw();
+		threadPool.QueueJobs( static_cast< uint64 >( numHelpers ), [ &state, statePtr, runRangePtr ]( const uint64 ) {
+			return [ state, statePtr, runRangePtr ]() {
+				range_t range;
+				if ( !statePtr->ClaimRange( range ) ) {
+					return;
+				}
+				const int64 participant = statePtr->NextParticipant();
+				do {
+					( *runRangePtr )( participant, range );
+					statePtr->CompleteRange( range );
+				} while ( statePtr->ClaimRange( range ) );
+			};
+		} );
+
+		range_t range;
+		while ( state->ClaimRange( range ) ) {
+			runRange( 0, range );
+			state->CompleteRange( range );
+		}
+
+		// help out with other jobs while the last chunks finish.
+		while ( !state->IsComplete() ) {
+			if ( !threadPool.TryRunPendingJob() ) {
+				qpThreadUtil::YieldThread();
+			}
+		}
+	}
+
+	inline int64 NumHelpers( const qpThreadPool & threadPool, const int64 begin, const int64 end, const int64 grainSize ) {
+		const int64 numChunks = ( end - begin + qpMath::Max( grainSize, 1ll ) - 1 ) / qpMath::Max( grainSize, 1ll );
+		return qpMath::Min( static_cast< int64 >( threadPool.NumWorkers() ), numChunks - 1 );
+	}
+}
+
+// func( int64 begin, int64 end ) is called for chunks of [begin, end).
+template < typename _func_ >
+void qpParallelForRange( qpThreadPool & threadPool, const int64 begin, const int64 end, const int64 grainSize, const _func_ & func ) {
+	if ( begin >= end ) {
+		return;
+	}
+	const int64 numHelpers = qpParallelInternal::NumHelpers( threadPool, begin, end, grainSize );
+	if ( numHelpers <= 0 ) {
+		func( begin, end );
+		return;
+	}
+	qpParallelInternal::Run( threadPool, begin, end, grainSize, numHelpers, [ & ]( const int64, const qpParallelInternal::range_t & range ) {
+		func( range.begin, range.end );
+	} );
+}
+
+// func( int64 index ) is called for every index in [begin, end).
+template < typename _func_ >
+void qpParallelFor( qpThreadPool & threadPool, const int64 begin, const int64 end, const int64 grainSize, const _func_ & func ) {
+	qpParallelForRange( threadPool, begin, end, grainSize, [ & ]( const int64 rangeBegin, const int64 rangeEnd ) {
+		for ( int64 index = rangeBegin; index < rangeEnd; ++index ) {
+			func( index );
+		}
+	} );
+}
+
+template < typename _type_, typename _func_ >
+void qpParallelFor( qpThreadPool & threadPool, qpList< _type_ > & list, const int64 grainSize, const _func_ & func ) {
+	_type_ * data = list.Data();
+	qpParallelFor( threadPool, 0, static_cast< int64 >( list.Length() ), grainSize, [ & ]( const int64 index ) { func( data[ index ] ); } );
+}
+
+template < typename _type_, int _size_, typename _func_ >
+void qpParallelFor( qpThreadPool & threadPool, qpArray< _type_, _size_ > & arr, const int64 grainSize, const _func_ & func ) {
+	_type_ * data = arr.Data();
+	qpParallelFor( threadPool, 0, static_cast< int64 >( arr.Length() ), grainSize, [ & ]( const int64 index ) { func( data[ index ] ); } );
+}
+
+template < typename _type_, typename _func_ >
+void qpParallelFor( qpThreadPool & threadPool, const qpArrayView< _type_ > & view, const int64 grainSize, const _func_ & func ) {
+	const _type_ * data = view.Data();
+	qpParallelFor( threadPool, 0, static_cast< int64 >( view.Length() ), grainSize, [ & ]( const int64 index ) { func( data[ index ] ); } );
+}
+
+// map( int64 index ) produces a value for every index and the values are folded together with combine( a, b ).
+// combine has to be associative and commutative since the order chunks get combined in isn't fixed.
+template < typename _result_, typename _map_, typename _combine_ >
+_result_ qpParallelReduce( qpThreadPool & threadPool, const int64 begin, const int64 end, const int64 grainSize, const _result_ & identity, const _map_ & map, const _combine_ & combine ) {
+	if ( begin >= end ) {
+		return identity;
+	}
+
+	auto reduceRange = [ & ]( const int64 rangeBegin, const int64 rangeEnd ) {
+		_result_ result = identity;
+		for ( int64 index = rangeBegin; index < rangeEnd; ++index ) {
+			result = combine( result, map( index ) );
+		}
+		return result;
+	};
+
+	const int64 numHelpers = qpParallelInternal::NumHelpers( threadPool, begin, end, grainSize );
+	if ( numHelpers <= 0 ) {
+		return reduceRange( begin, end );
+	}
+
+	// one partial result per participant, padded so participants don't share cache lines.
+	struct alignas( 64 ) partial_t {
+		_result_ value;
+	};
+	qpList< partial_t > partials( static_cast< int >( numHelpers + 1 ), partial_t { identity } );
+	partial_t * partialsData = partials.Data();
+
+	qpParallelInternal::Run( threadPool, begin, end, grainSize, numHelpers, [ & ]( const int64 participant, const qpParallelInternal::range_t & range ) {
+		partialsData[ participant ].value = combine( partialsData[ participant ].value, reduceRange( range.begin, range.end ) );
+	} );
+
+	_result_ result = identity;
+	for ( const partial_t & partial : partials ) {
+		result = combine( result, partial.value );
+	}
+	return result;
+}
+
+template < typename _result_, typename _type_, typename _map_, typename _combine_ >
+_result_ qpParallelReduce( qpThreadPool & threadPool, const qpArrayView< _type_ > & view, const int64 grainSize, const _result_ & identity, const _map_ & map, const _combine_ & combine ) {
+	const _type_ * data = view.Data();
+	return qpParallelReduce( threadPool, 0, static_cast< int64 >( view.Length() ), grainSize, identity, [ & ]( const int64 index ) { return map( data[ index ] ); }, combine );
+}
+
+template < typename _result_, typename _type_, typename _map_, typename _combine_ >
+_result_ qpParallelReduce( qpThreadPool & threadPool, const qpList< _type_ > & list, const int64 grainSize, const _result_ & identity, const _map_ & map, const _combine_ & combine ) {
+	return qpParallelReduce( threadPool, qpArrayView< _type_ >( list ), grainSize, identity, map, combine );
+}
+
+template < typename _result_, typename _type_, int _size_, typename _map_, typename _combine_ >
+_result_ qpParallelReduce( qpThreadPool & threadPool, const qpArray< _type_, _size_ > & arr, const int64 grainSize, const _result_ & identity, const _map_ & map, const _combine_ & combine ) {
+	return qpParallelReduce( threadPool, qpArrayView< _type_ >( arr ), grainSize, identity, map, combine );
+}
@@ -0,0 +1,76 @@
+#include "engine.pch.h"
+#include "qp_task.h"
+
+namespace {
+	const size_t s_frameBucketGranularity = 64;
+	const size_t s_numFrameBuckets = 32; // frames up to 2 KiB are pooled
+	const uint32 s_maxFreeFramesPerBucket = 64;
+
+	struct freeFrame_t {
+		freeFrame_t * next = NULL;
+	};
+
+	struct frameBucket_t {
+		freeFrame_t * freeFrames = NULL;
+		uint32 numFreeFrames = 0;
+	};
+
+	struct frameCache_t {
+		frameBucket_t buckets[ s_numFrameBuckets ];
+
+		~frameCache_t() {
+			for ( frameBucket_t & bucket : buckets ) {
+				while ( bucket.freeFrames != NULL ) {
+					freeFrame_t * frame = bucket.freeFrames;
+					bucket.freeFrames = frame->next;
+					::operator delete( frame );
+				}
+			}
+		}
+	};
+
+	frameCache_t & GetFrameCache() {
+		static thread_local frameCache_t frameCache;
+		return frameCache;
+	}
+
+	size_t FrameBucketIndex( const size_t size ) { return ( size + s_frameBucketGranularity - 1 ) / s_frameBucketGranularity - 1; }
+}
+
+void * qpCoroutineFrameAllocator::Allocate( const size_t size ) {
+	const size_t bucketIndex = FrameBucketIndex( size );
+	if ( bucketIndex >= s_numFrameBuckets ) {
+		return ::operator new( size );
+	}
+
+	frameBucket_t & bucket = GetFrameCache().buckets[ bucketIndex ];
+	if ( bucket.freeFrames != NULL ) {
+		freeFrame_t * frame = bucket.freeFrames;
+		bucket.freeFrames = frame->next;
+		--bucket.numFreeFrames;
+		return frame;
+	}
+	// always allocate the full bucket size so the frame can be reused by any coroutine in the same bucket.
+	return ::operator new( ( bucketIndex + 1 ) * s_frameBucketGranularity );
+}
+
+void qpCoroutineFrameAllocator::Free( void * ptr, const size_t size ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	const size_t bucketIndex = FrameBucketIndex( size );
+	if ( bucketIndex >= s_numFrameBuckets ) {
+		::operator delete( ptr );
+		return;
+	}
+
+	frameBucket_t & bucket = GetFrameCache().buckets[ bucketIndex ];
+	if ( bucket.numFreeFrames >= s_maxFreeFramesPerBucket ) {
+		::operator delete( ptr );
+		return;
+	}
+	freeFrame_t * frame = new ( ptr ) freeFrame_t();
+	frame->next = bucket.freeFrames;
+	bucket.freeFrames = frame;
+	++bucket.numFreeFrames;
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <new>
+
+// Hands out coroutine frames from per thread free lists bucketed by size so
+// starting a task doesn't have to go through the global heap once the buckets are warm.
+// Frames freed on another thread than they were allocated on end up in that thread's free lists.
+class qpCoroutineFrameAllocator {
+public:
+	static void * Allocate( const size_t size );
+	static void Free( void * ptr, const size_t size );
+};
+
+// storage for a value that is constructed later, doesn't require the type to be default constructible.
+template < typename _type_ >
+class qpTaskResult {
+public:
+	qpTaskResult() = default;
+	~qpTaskResult() { Reset(); }
+
+	qpTaskResult( const qpTaskResult & other ) = delete;
+	qpTaskResult & operator=( const qpTaskResult & other ) = delete;
+
+	template < typename _value_ >
+	void Set( _value_ && value ) {
+		Reset();
+		new ( m_storage ) _type_( qpForward< _value_ >( value ) );
+		m_hasValue = true;
+	}
+	_type_ & Get() {
+		QP_ASSERT_MSG( m_hasValue, "Task result hasn't been set." );
+		return *std::launder( reinterpret_cast< _type_ * >( m_storage ) );
+	}
+	bool HasValue() const { return m_hasValue; }
+	void Reset() {
+		if ( m_hasValue ) {
+			Get().~_type_();
+			m_hasValue = false;
+		}
+	}
+private:
+	alignas( _type_ ) uint8 m_storage[ sizeof( _type_ ) ];
+	bool m_hasValue = false;
+};
+
+template < typename _type_ = void >
+class qpTask;
+
+namespace qpTaskInternal {
+	class qpPromiseBase {
+	public:
+		static void * operator new( const size_t size ) { return qpCoroutineFrameAllocator::Allocate( size ); }
+		static void operator delete( void * ptr, const size_t size ) { qpCoroutineFrameAllocator::Free( ptr, size ); }
+
+		struct finalAwaiter_t {
+			bool await_ready() const noexcept { return false; }
+			template < typename _promise_ >
+			std::coroutine_handle<> await_suspend( std::coroutine_handle< _promise_ > handle ) const noexcept {
+				// resume whoever awaited the task right away on this thread.
+				std::coroutine_handle<> continuation = handle.promise().m_continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+			void await_resume() const noexcept {}
+		};
+
+		// tasks are lazy and start once they are awaited.
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		finalAwaiter_t final_suspend() const noexcept { return {}; }
+		void unhandled_exception() { m_exception = std::current_exception(); }
+
+		void SetContinuation( const std::coroutine_handle<> continuation ) { m_continuation = continuation; }
+		void RethrowIfFailed() const {
+			if ( m_exception ) {
+				std::rethrow_exception( m_exception );
+			}
+		}
+	private:
+		std::coroutine_handle<> m_continuation;
+		std::exception_ptr m_exception;
+	};
+
+	template < typename _type_ >
+	class qpPromise : public qpPromiseBase {
+	public:
+		qpTask< _type_ > get_return_object();
+
+		template < typename _value_ >
+		void return_value( _value_ && value ) { m_result.Set( qpForward< _value_ >( value ) ); }
+
+		_type_ & GetResult() {
+			RethrowIfFailed();
+			return m_result.Get();
+		}
+	private:
+		qpTaskResult< _type_ > m_result;
+	};
+
+	template <>
+	class qpPromise< void > : public qpPromiseBase {
+	public:
+		qpTask< void > get_return_object();
+
+		void return_void() const {}
+
+		void GetResult() const { RethrowIfFailed(); }
+	};
+}
+
+// Lazily started coroutine that produces a _type_. co_await the task from another coroutine
+// or block on it with qpSyncWait. The awaiting coroutine continues on the thread the task finished on.
+template < typename _type_ >
+class qpTask {
+public:
+	using promise_type = qpTaskInternal::qpPromise< _type_ >;
+
+	qpTask() = default;
+	explicit qpTask( const std::coroutine_handle< promise_type > handle ) : m_handle( handle ) {}
+	qpTask( const qpTask & other ) = delete;
+	qpTask( qpTask && other ) noexcept : m_handle( other.m_handle ) { other.m_handle = NULL; }
+	~qpTask() { Destroy(); }
+
+	qpTask & operator=( const qpTask & rhs ) = delete;
+	qpTask & operator=( qpTask && rhs ) noexcept {
+		if ( this != &rhs ) {
+			Destroy();
+			m_handle = rhs.m_handle;
+			rhs.m_handle = NULL;
+		}
+		return *this;
+	}
+
+	bool IsValid() const { return m_handle != NULL; }
+	bool IsDone() const { return !m_handle || m_handle.done(); }
+
+	auto operator co_await() && noexcept {
+		struct awaiter_t {
+			std::coroutine_handle< promise_type > handle;
+
+			bool await_ready() const noexcept { return !handle || handle.done(); }
+			std::coroutine_handle<> await_suspend( const std::coroutine_handle<> awaiting ) const noexcept {
+				handle.promise().SetContinuation( awaiting );
+				return handle;
+			}
+			decltype( auto ) await_resume() const {
+				QP_ASSERT_MSG( handle != NULL, "Awaiting a task that doesn't have a coroutine." );
+				if constexpr ( IsSame< _type_, void > ) {
+					handle.promise().GetResult();
+				} else {
+					return qpMove( handle.promise().GetResult() );
+				}
+			}
+		};
+		return awaiter_t { m_handle };
+	}
+private:
+	std::coroutine_handle< promise_type > m_handle;
+
+	void Destroy() {
+		if ( m_handle ) {
+			m_handle.destroy();
+			m_handle = NULL;
+		}
+	}
+};
+
+namespace qpTaskInternal {
+	template < typename _type_ >
+	qpTask< _type_ > qpPromise< _type_ >::get_return_object() {
+		return qpTask< _type_ >( std::coroutine_handle< qpPromise >::from_promise( *this ) );
+	}
+
+	inline qpTask< void > qpPromise< void >::get_return_object() {
+		return qpTask< void >( std::coroutine_handle< qpPromise >::from_promise( *this ) );
+	}
+
+	struct syncWaitState_t {
+		std::mutex mutex;
+		std::condition_variable conditionVar;
+		bool done = false;
+	};
+
+	class qpSyncWaitTask {
+	public:
+		struct promise_type {
+			syncWaitState_t * state = NULL;
+			std::exception_ptr exception;
+
+			static void * operator new( const size_t size ) { return qpCoroutineFrameAllocator::Allocate( size ); }
+			static void operator delete( void * ptr, const size_t size ) { qpCoroutineFrameAllocator::Free( ptr, size ); }
+
+			qpSyncWaitTask get_return_object() { return qpSyncWaitTask( std::coroutine_handle< promise_type >::from_promise( *this ) ); }
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			auto final_suspend() const noexcept {
+				struct finalAwaiter_t {
+					bool await_ready() const noexcept { return false; }
+					void await_suspend( const std::coroutine_handle< promise_type > handle ) const noexcept {
+						// the waiting thread destroys the frame as soon as it sees done, so nothing in the frame can be touched after this.
+						syncWaitState_t * waitState = handle.promise().state;
+						std::scoped_lock lock( waitState->mutex );
+						waitState->done = true;
+						waitState->conditionVar.notify_one();
+					}
+					void await_resume() const noexcept {}
+				};
+				return finalAwaiter_t {};
+			}
+			void return_void() const {}
+			void unhandled_exception() { exception = std::current_exception(); }
+		};
+
+		explicit qpSyncWaitTask( const std::coroutine_handle< promise_type > handle ) : m_handle( handle ) {}
+		qpSyncWaitTask( const qpSyncWaitTask & other ) = delete;
+		~qpSyncWaitTask() { m_handle.destroy(); }
+
+		void Wait() {
+			syncWaitState_t waitState;
+			m_handle.promise().state = &waitState;
+			m_handle.resume();
+			std::unique_lock lock( waitState.mutex );
+			waitState.conditionVar.wait( lock, [ & ]() { return waitState.done; } );
+			if ( m_handle.promise().exception ) {
+				std::rethrow_exception( m_handle.promise().exception );
+			}
+		}
+	private:
+		std::coroutine_handle< promise_type > m_handle;
+	};
+
+	template < typename _type_ >
+	qpSyncWaitTask MakeSyncWaitTask( qpTask< _type_ > & task, qpTaskResult< _type_ > & result ) {
+		result.Set( co_await qpMove( task ) );
+	}
+
+	inline qpSyncWaitTask MakeSyncWaitTask( qpTask< void > & task ) {
+		co_await qpMove( task );
+	}
+}
+
+// blocks the calling thread until the task has finished, don't call it from a worker the task depends on.
+template < typename _type_ >
+_type_ qpSyncWait( qpTask< _type_ > && task ) {
+	if constexpr ( IsSame< _type_, void > ) {
+		qpTaskInternal::MakeSyncWaitTask( task ).Wait();
+	} else {
+		qpTaskResult< _type_ > result;
+		qpTaskInternal::MakeSyncWaitTask( task, result ).Wait();
+		return qpMove( result.Get() );
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "qp_char_traits.h"
 #include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/allocation/qp_memory_tracking.h"
 #include "qp/common/debug/qp_debug.h"
 #include "qp/common/utilities/qp_utility.h"
 #include "qp/common/math/qp_math.h"
@@ -169,6 +170,8 @@ public:
 	};
 
 	qpStringBase();
+	// memory beyond the static buffer is allocated through allocator, which has to outlive the string.
+	explicit qpStringBase( qpAllocator & allocator ) requires ( _allowAlloc_ );
 	explicit qpStringBase( const int capacity ) requires ( _allowAlloc_ );
 	qpStringBase( const int length, const _type_ charToInsert ) requires ( _allowAlloc_ );
 	qpStringBase( const _type_ c );
@@ -198,6 +201,7 @@ public:
 
 	bool IsAllocated() const;
 
+	qpAllocator & GetAllocator() const { return ( m_allocator != NULL ) ? *m_allocator : qpGetAllocator( memoryCategory_t::STRING ); }
 	_type_ & At( int index );
 	const _type_ & At( int index ) const;
 
@@ -285,6 +289,8 @@ private:
 	int m_length = 0;
 	_type_ * m_data = m_staticBuffer;
 	_type_ m_staticBuffer[ _staticBufferCapacity_ ] {};
+	// NULL means the STRING category allocator, which is only looked up once the string allocates.
+	qpAllocator * m_allocator = NULL;
 };
 
 using qpString = qpStringBase< char >;
@@ -312,6 +318,9 @@ using qpDynamicStaticWideString = qpDynamicStaticStringBase< wchar_t, _capacity_
 template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
 qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::qpStringBase() {}
 
+template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
+qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::qpStringBase( qpAllocator & allocator ) requires ( _allowAlloc_ ) : m_allocator( &allocator ) {}
+
 template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
 qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::qpStringBase( const int capacity )  requires ( _allowAlloc_ ) {
 	QP_ASSERT_MSG( capacity >= 0, "Capacity can't be less than 0." );
@@ -345,7 +354,9 @@ qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::qpStri
 		FreeMemory();
 	}
 	if ( rhs.IsAllocated() ) {
+		// the memory has to go back to the allocator it came from.
 		m_data = rhs.m_data;
+		m_allocator = rhs.m_allocator;
 	} else {
 		m_data = m_staticBuffer;
 		QP_ASSERT( rhs.m_capacity == _staticBufferCapacity_ );
@@ -522,7 +533,9 @@ void qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::R
 	QP_ASSERT( requestedCapacity > _staticBufferCapacity_ );
 
 	uint64 capacity = qpAllocationUtil::AlignSize( qpVerifyStaticCast< size_t >( requestedCapacity ), 8 * sizeof( _type_ ) );
-	_type_ * newData = new _type_[ capacity ] { };
+	_type_ * newData = static_cast< _type_ * >( GetAllocator().Allocate( capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+	QP_ASSERT_MSG( newData != NULL, "String allocator is out of memory." );
+	qpZeroMemory( newData, capacity * sizeof( _type_ ) );
 	qpCopyBytes( newData, capacity * sizeof( _type_ ), m_data, qpVerifyStaticCast< uint64 >( m_length ) * sizeof( _type_ ) );
 	FreeMemory();
 	m_data = newData;
@@ -539,7 +552,7 @@ void qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::S
 		return;
 	}
 
-	_type_ * fittedData = ( fittedCapacity == _staticBufferCapacity_ ) ? m_staticBuffer : new _type_[ fittedCapacity ] {};
+	_type_ * fittedData = ( fittedCapacity == _staticBufferCapacity_ ) ? m_staticBuffer : static_cast< _type_ * >( GetAllocator().Allocate( fittedCapacity * sizeof( _type_ ), alignof( _type_ ) ) );
 	qpCopyBytes( fittedData, fittedCapacity * sizeof( _type_ ), m_data, ( m_length + 1 ) * sizeof(_type_));
 	FreeMemory();
 	m_data = fittedData;
@@ -566,7 +579,7 @@ void qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::C
 template< typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
 void qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ >::FreeMemory() requires ( _allowAlloc_ ) {
 	if ( IsAllocated() ) {
-		delete[] m_data;
+		GetAllocator().Free( m_data, qpVerifyStaticCast< uint64 >( m_capacity ) * sizeof( _type_ ) );
 		m_data = m_staticBuffer;
 		m_capacity = _staticBufferCapacity_;
 	}
@@ -814,7 +827,9 @@ qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ > & qpStr
 		FreeMemory();
 	}
 	if ( rhs.IsAllocated() ) {
+		// the memory has to go back to the allocator it came from.
 		m_data = rhs.m_data;
+		m_allocator = rhs.m_allocator;
 	} else {
 		m_data = m_staticBuffer;
 		QP_ASSERT( rhs.m_capacity == _staticBufferCapacity_ );
@@ -887,6 +902,28 @@ static inline qpWideString qpFormat( const wchar_t * const format, _args_&&... a
 	return formatted;
 }
 
+// formats into a string that allocates from allocator, e.g. the scratch allocator for strings that don't outlive a qpScratchScope.
+template < typename... _args_ >
+static inline qpString qpFormat( qpAllocator & allocator, const char * const format, _args_&&... args ) {
+	qpString formatted( allocator );
+	formatted.Format( format, qpForward< _args_ >( args )... );
+	return formatted;
+}
+
+template < typename... _args_ >
+static inline qpU8String qpFormat( qpAllocator & allocator, const char8_t * const format, _args_&&... args ) {
+	qpU8String formatted( allocator );
+	formatted.Format( format, qpForward< _args_ >( args )... );
+	return formatted;
+}
+
+template < typename... _args_ >
+static inline qpWideString qpFormat( qpAllocator & allocator, const wchar_t * const format, _args_&&... args ) {
+	qpWideString formatted( allocator );
+	formatted.Format( format, qpForward< _args_ >( args )... );
+	return formatted;
+}
+
 // defined per platform
 extern qpWideString qpUTF8ToWide( const char * string, const int length );
 extern qpWideString qpUTF8ToWide( const qpString & string );
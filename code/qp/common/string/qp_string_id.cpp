@@ -0,0 +1,89 @@
+#include "engine.pch.h"
+#include "qp_string_id.h"
+#include "qp/common/containers/qp_hash_map.h"
+#include "qp/common/math/qp_math.h"
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+
+#if defined( QP_STRING_ID_NAMES )
+namespace {
+	// interned strings live for the rest of the program so they are packed into blocks that are never freed.
+	const uint64 s_stringBlockSize = 64 * 1024;
+
+	struct stringTable_t {
+		std::shared_mutex mutex;
+		qpHashMap< qpStringId, const char * > strings { qpGetSystemAllocator() };
+		char * block = NULL;
+		uint64 blockSize = 0;
+		uint64 blockOffset = 0;
+	};
+
+	// never destroyed so ids can still be made while statics are destroyed. the table goes straight to the
+	// system allocator since it is never freed and would otherwise show up in the leak report.
+	stringTable_t & GetStringTable() {
+		static stringTable_t * stringTable = new stringTable_t();
+		return *stringTable;
+	}
+
+	const char * CopyString( stringTable_t & table, const char * string, const int length ) {
+		const uint64 size = static_cast< uint64 >( length ) + 1;
+		if ( table.blockOffset + size > table.blockSize ) {
+			table.blockSize = qpMath::Max( s_stringBlockSize, size );
+			table.block = static_cast< char * >( qpGetSystemAllocator().Allocate( table.blockSize, 1 ) );
+			table.blockOffset = 0;
+		}
+		char * copy = table.block + table.blockOffset;
+		memcpy( copy, string, static_cast< size_t >( length ) );
+		copy[ length ] = '\0';
+		table.blockOffset += size;
+		return copy;
+	}
+
+	void CheckCollision( const char * interned, const char * string, const int length ) {
+		if ( ( qpStrLen( interned ) != length ) || ( strncmp( interned, string, static_cast< size_t >( length ) ) != 0 ) ) {
+			qpDebug::Error( "StringId: \"%s\" and \"%.*s\" have the same id.", interned, length, string );
+		}
+	}
+
+	void Intern( const qpStringId id, const char * string, const int length ) {
+		stringTable_t & table = GetStringTable();
+		{
+			std::shared_lock lock( table.mutex );
+			const char * const * interned = table.strings.Find( id );
+			if ( interned != NULL ) {
+				CheckCollision( *interned, string, length );
+				return;
+			}
+		}
+		std::unique_lock lock( table.mutex );
+		// another thread can have interned the string while the lock was released.
+		const char * const * interned = table.strings.Find( id );
+		if ( interned != NULL ) {
+			CheckCollision( *interned, string, length );
+			return;
+		}
+		table.strings.Insert( id, CopyString( table, string, length ) );
+	}
+}
+#endif
+
+qpStringId::qpStringId( const char * string ) : qpStringId( string, qpStrLen( string ) ) {
+}
+
+qpStringId::qpStringId( const char * string, const int length ) : m_id( IdFromHash( qpHashString( string, length ) ) ) {
+#if defined( QP_STRING_ID_NAMES )
+	Intern( *this, string, length );
+#endif
+}
+
+const char * qpStringId::GetString() const {
+#if defined( QP_STRING_ID_NAMES )
+	stringTable_t & table = GetStringTable();
+	std::shared_lock lock( table.mutex );
+	const char * const * interned = table.strings.Find( *this );
+	return ( interned != NULL ) ? *interned : NULL;
+#else
+	return NULL;
+#endif
+}
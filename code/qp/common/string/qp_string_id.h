@@ -0,0 +1,48 @@
+#pragma once
+#include "qp/common/core/qp_types.h"
+#include "qp/common/utilities/qp_hash.h"
+#include <compare>
+
+#if !defined( QP_STRING_ID_NAMES )
+#if !defined( QP_RETAIL )
+#define QP_STRING_ID_NAMES
+#endif
+#endif
+
+// Compact id for a string such as a resource or asset name, comparing ids is a single integer compare.
+// The id is the 64 bit hash of the string so ids of literals are made at compile time with "name"_sid and
+// equal the id of the same string made at runtime. Outside of retail builds every string made into an id at
+// runtime is interned in a global table so the name can be looked up again, and two strings that hash to
+// the same id are reported.
+class qpStringId {
+public:
+	constexpr qpStringId() = default;
+	explicit qpStringId( const char * string );
+	qpStringId( const char * string, const int length );
+
+	static constexpr qpStringId FromString( const char * string, const int length ) { return qpStringId( IdFromHash( qpHashString( string, length ) ) ); }
+
+	constexpr uint64 GetId() const { return m_id; }
+	constexpr bool IsValid() const { return m_id != 0; }
+	// the interned string, NULL for ids that were only made at compile time, invalid ids and in retail builds.
+	const char * GetString() const;
+
+	constexpr bool operator==( const qpStringId & other ) const = default;
+	constexpr std::strong_ordering operator<=>( const qpStringId & other ) const = default;
+private:
+	uint64 m_id = 0;
+
+	explicit constexpr qpStringId( const uint64 id ) : m_id( id ) {}
+	// zero is kept for invalid ids.
+	static constexpr uint64 IdFromHash( const uint64 hash ) { return ( hash != 0 ) ? hash : 1; }
+};
+
+consteval qpStringId operator""_sid( const char * string, const size_t length ) {
+	return qpStringId::FromString( string, static_cast< int >( length ) );
+}
+
+template <>
+struct qpHash< qpStringId > {
+	// the id already is a hash.
+	uint64 operator()( const qpStringId id ) const { return id.GetId(); }
+};
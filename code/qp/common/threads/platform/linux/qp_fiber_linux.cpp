@@ -0,0 +1,75 @@
+#include "engine.pch.h"
+
+#if defined( QP_PLATFORM_LINUX )
+#include "qp/common/threads/qp_fiber.h"
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace {
+	struct fiberContext_t {
+		ucontext_t context;
+		void * mapping = NULL;
+		uint64 mappingSize = 0;
+	};
+
+	void FiberEntryTrampoline( const uint32 fiberLow, const uint32 fiberHigh ) {
+		// makecontext only passes ints so the fiber pointer is split in two.
+		qpFiber::Entry( reinterpret_cast< qpFiber * >( ( static_cast< uintptr_t >( fiberHigh ) << 32 ) | fiberLow ) );
+	}
+}
+
+qpFiber::qpFiber() {
+	m_context = new fiberContext_t();
+}
+
+qpFiber::qpFiber( const uint64 stackSize, fiberFunction_t func, void * userData ) : m_func( func ), m_userData( userData ) {
+	fiberContext_t * context = new fiberContext_t();
+	m_context = context;
+
+	const uint64 pageSize = static_cast< uint64 >( sysconf( _SC_PAGESIZE ) );
+	m_stackSize = ( ( stackSize + pageSize - 1 ) / pageSize ) * pageSize;
+
+	// one extra page at the bottom of the stack is left inaccessible so overflows fault instead of corrupting memory.
+	context->mappingSize = m_stackSize + pageSize;
+	context->mapping = mmap( NULL, context->mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0 );
+	if ( !QP_VERIFY_MSG( context->mapping != MAP_FAILED, "Failed to map fiber stack." ) ) {
+		context->mapping = NULL;
+		return;
+	}
+	mprotect( context->mapping, pageSize, PROT_NONE );
+
+	getcontext( &context->context );
+	context->context.uc_stack.ss_sp = static_cast< uint8 * >( context->mapping ) + pageSize;
+	context->context.uc_stack.ss_size = m_stackSize;
+	context->context.uc_link = NULL;
+
+	const uintptr_t fiberAddress = reinterpret_cast< uintptr_t >( this );
+	makecontext( &context->context, reinterpret_cast< void ( * )() >( &FiberEntryTrampoline ), 2,
+		static_cast< uint32 >( fiberAddress & 0xFFFFFFFF ), static_cast< uint32 >( fiberAddress >> 32 ) );
+}
+
+qpFiber::~qpFiber() {
+	fiberContext_t * context = static_cast< fiberContext_t * >( m_context );
+	if ( context->mapping != NULL ) {
+		munmap( context->mapping, context->mappingSize );
+	}
+	delete context;
+}
+
+void qpFiber::SwitchTo( qpFiber & fiber ) {
+	if ( &fiber == this ) {
+		return;
+	}
+	fiberContext_t * from = static_cast< fiberContext_t * >( m_context );
+	fiberContext_t * to = static_cast< fiberContext_t * >( fiber.m_context );
+	swapcontext( &from->context, &to->context );
+}
+
+void qpFiber::Entry( qpFiber * fiber ) {
+	fiber->m_func( fiber->m_userData );
+	// returning from a fiber would end the thread since there is no uc_link.
+	qpDebug::CriticalError( "Fiber function returned, fibers have to switch away when they are done." );
+}
+
+#endif
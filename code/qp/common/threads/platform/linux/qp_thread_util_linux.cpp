@@ -0,0 +1,146 @@
+#include "engine.pch.h"
+
+#if defined( QP_PLATFORM_LINUX )
+#include "qp/common/threads/qp_thread_util.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+	const char * s_sysCpuPath = "/sys/devices/system/cpu";
+	// pthread names are limited to 16 characters including the terminator.
+	const int s_maxThreadNameLength = 15;
+
+	bool ReadSysFile( const char * path, char * buffer, const int bufferSize ) {
+		FILE * file = fopen( path, "r" );
+		if ( file == NULL ) {
+			return false;
+		}
+		const bool success = fgets( buffer, bufferSize, file ) != NULL;
+		fclose( file );
+		return success;
+	}
+
+	// parses lists such as "0-3,8-11" that sysfs uses for sets of cpus.
+	qpList< uint32 > ParseCpuList( const char * list ) {
+		qpList< uint32 > cpus;
+		const char * cursor = list;
+		while ( ( *cursor >= '0' ) && ( *cursor <= '9' ) ) {
+			char * end = NULL;
+			const uint32 first = static_cast< uint32 >( strtoul( cursor, &end, 10 ) );
+			uint32 last = first;
+			cursor = end;
+			if ( *cursor == '-' ) {
+				last = static_cast< uint32 >( strtoul( cursor + 1, &end, 10 ) );
+				cursor = end;
+			}
+			for ( uint32 cpu = first; cpu <= last; ++cpu ) {
+				cpus.Push( cpu );
+			}
+			if ( *cursor == ',' ) {
+				++cursor;
+			}
+		}
+		return cpus;
+	}
+
+	// the first cpu in a sysfs cpu list file identifies the whole group, returns false if the file is missing.
+	bool ReadFirstCpuInList( const char * path, uint32 & outCpu ) {
+		char buffer[ 1024 ];
+		if ( !ReadSysFile( path, buffer, sizeof( buffer ) ) ) {
+			return false;
+		}
+		const qpList< uint32 > cpus = ParseCpuList( buffer );
+		if ( cpus.IsEmpty() ) {
+			return false;
+		}
+		outCpu = cpus[ 0 ];
+		return true;
+	}
+
+	// the last level cache is the highest level index that is shared, usually the L3.
+	bool ReadCacheGroupKey( const uint32 cpu, uint32 & outKey ) {
+		char path[ 256 ];
+		char buffer[ 64 ];
+		int highestLevel = 0;
+		for ( int cacheIndex = 0; ; ++cacheIndex ) {
+			snprintf( path, sizeof( path ), "%s/cpu%u/cache/index%d/level", s_sysCpuPath, cpu, cacheIndex );
+			if ( !ReadSysFile( path, buffer, sizeof( buffer ) ) ) {
+				break;
+			}
+			const int level = atoi( buffer );
+			if ( level <= highestLevel ) {
+				continue;
+			}
+			snprintf( path, sizeof( path ), "%s/cpu%u/cache/index%d/shared_cpu_list", s_sysCpuPath, cpu, cacheIndex );
+			if ( ReadFirstCpuInList( path, outKey ) ) {
+				highestLevel = level;
+			}
+		}
+		return highestLevel != 0;
+	}
+
+	uint32 DenseIndex( qpList< uint32 > & keys, const uint32 key ) {
+		for ( uint64 index = 0; index < keys.Length(); ++index ) {
+			if ( keys[ index ] == key ) {
+				return static_cast< uint32 >( index );
+			}
+		}
+		keys.Push( key );
+		return static_cast< uint32 >( keys.Length() - 1 );
+	}
+}
+
+cpuTopology_t qpThreadUtil::QueryCpuTopology() {
+	cpuTopology_t topology;
+	char path[ 256 ];
+	char buffer[ 1024 ];
+	snprintf( path, sizeof( path ), "%s/online", s_sysCpuPath );
+	if ( !ReadSysFile( path, buffer, sizeof( buffer ) ) ) {
+		return topology;
+	}
+
+	qpList< uint32 > physicalCoreKeys;
+	qpList< uint32 > cacheGroupKeys;
+	for ( const uint32 cpu : ParseCpuList( buffer ) ) {
+		// siblings sharing a physical core all list the same cpus so the first one identifies the core.
+		uint32 physicalCoreKey = cpu;
+		snprintf( path, sizeof( path ), "%s/cpu%u/topology/thread_siblings_list", s_sysCpuPath, cpu );
+		ReadFirstCpuInList( path, physicalCoreKey );
+
+		uint32 cacheGroupKey = 0;
+		ReadCacheGroupKey( cpu, cacheGroupKey );
+
+		cpuTopology_t::logicalCore_t & logicalCore = topology.logicalCores.Emplace();
+		logicalCore.index = cpu;
+		logicalCore.physicalCore = DenseIndex( physicalCoreKeys, physicalCoreKey );
+		logicalCore.cacheGroup = DenseIndex( cacheGroupKeys, cacheGroupKey );
+	}
+	topology.numPhysicalCores = static_cast< uint32 >( physicalCoreKeys.Length() );
+	topology.numCacheGroups = static_cast< uint32 >( cacheGroupKeys.Length() );
+	return topology;
+}
+
+bool qpThreadUtil::SetCurrentThreadAffinity( const uint32 logicalCore ) {
+	if ( !QP_VERIFY_MSG( logicalCore < CPU_SETSIZE, "Logical core is out of range." ) ) {
+		return false;
+	}
+	cpu_set_t cpuSet;
+	CPU_ZERO( &cpuSet );
+	CPU_SET( logicalCore, &cpuSet );
+	const int result = pthread_setaffinity_np( pthread_self(), sizeof( cpuSet ), &cpuSet );
+	if ( result != 0 ) {
+		qpDebug::Warning( "ThreadUtil: Failed to set thread affinity to core %u, error %d.", logicalCore, result );
+		return false;
+	}
+	return true;
+}
+
+void qpThreadUtil::SetCurrentThreadName( const char * name ) {
+	char truncatedName[ s_maxThreadNameLength + 1 ];
+	snprintf( truncatedName, sizeof( truncatedName ), "%s", name );
+	pthread_setname_np( pthread_self(), truncatedName );
+}
+
+#endif
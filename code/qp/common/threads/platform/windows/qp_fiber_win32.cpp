@@ -0,0 +1,60 @@
+#include "engine.pch.h"
+
+#if defined( QP_PLATFORM_WINDOWS )
+#include "qp/common/threads/qp_fiber.h"
+#include "qp/common/platform/windows/qp_windows.h"
+
+namespace {
+	struct fiberContext_t {
+		LPVOID fiber = NULL;
+		bool convertedThread = false;
+	};
+
+	void WINAPI FiberEntryTrampoline( LPVOID parameter ) {
+		qpFiber::Entry( static_cast< qpFiber * >( parameter ) );
+	}
+}
+
+qpFiber::qpFiber() {
+	fiberContext_t * context = new fiberContext_t();
+	m_context = context;
+	if ( IsThreadAFiber() ) {
+		context->fiber = GetCurrentFiber();
+	} else {
+		context->fiber = ConvertThreadToFiber( NULL );
+		context->convertedThread = true;
+	}
+	QP_ASSERT_MSG( context->fiber != NULL, "Failed to convert thread to fiber." );
+}
+
+qpFiber::qpFiber( const uint64 stackSize, fiberFunction_t func, void * userData ) : m_stackSize( stackSize ), m_func( func ), m_userData( userData ) {
+	fiberContext_t * context = new fiberContext_t();
+	m_context = context;
+	context->fiber = CreateFiber( static_cast< SIZE_T >( stackSize ), &FiberEntryTrampoline, this );
+	QP_ASSERT_MSG( context->fiber != NULL, "Failed to create fiber." );
+}
+
+qpFiber::~qpFiber() {
+	fiberContext_t * context = static_cast< fiberContext_t * >( m_context );
+	if ( context->convertedThread ) {
+		ConvertFiberToThread();
+	} else if ( !IsThreadFiber() && ( context->fiber != NULL ) ) {
+		DeleteFiber( context->fiber );
+	}
+	delete context;
+}
+
+void qpFiber::SwitchTo( qpFiber & fiber ) {
+	if ( &fiber == this ) {
+		return;
+	}
+	SwitchToFiber( static_cast< fiberContext_t * >( fiber.m_context )->fiber );
+}
+
+void qpFiber::Entry( qpFiber * fiber ) {
+	fiber->m_func( fiber->m_userData );
+	// returning from a fiber function exits the thread.
+	qpDebug::CriticalError( "Fiber function returned, fibers have to switch away when they are done." );
+}
+
+#endif
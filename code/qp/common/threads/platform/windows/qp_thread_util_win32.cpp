@@ -0,0 +1,87 @@
+#include "engine.pch.h"
+
+#if defined( QP_PLATFORM_WINDOWS )
+#include "qp/common/threads/qp_thread_util.h"
+#include "qp/common/platform/windows/qp_windows.h"
+
+namespace {
+	uint32 DenseIndex( qpList< ULONG_PTR > & masks, const ULONG_PTR mask ) {
+		for ( uint64 index = 0; index < masks.Length(); ++index ) {
+			if ( masks[ index ] == mask ) {
+				return static_cast< uint32 >( index );
+			}
+		}
+		masks.Push( mask );
+		return static_cast< uint32 >( masks.Length() - 1 );
+	}
+}
+
+// only sees the processor group the process runs in, which is at most 64 logical cores.
+cpuTopology_t qpThreadUtil::QueryCpuTopology() {
+	cpuTopology_t topology;
+	DWORD bufferSize = 0;
+	GetLogicalProcessorInformation( NULL, &bufferSize );
+	if ( GetLastError() != ERROR_INSUFFICIENT_BUFFER ) {
+		return topology;
+	}
+	qpList< SYSTEM_LOGICAL_PROCESSOR_INFORMATION > infos( static_cast< int >( bufferSize / sizeof( SYSTEM_LOGICAL_PROCESSOR_INFORMATION ) ) );
+	if ( !GetLogicalProcessorInformation( infos.Data(), &bufferSize ) ) {
+		return topology;
+	}
+
+	qpList< ULONG_PTR > coreMasks;
+	qpList< ULONG_PTR > cacheMasks;
+	BYTE lastLevelCache = 0;
+	for ( const SYSTEM_LOGICAL_PROCESSOR_INFORMATION & info : infos ) {
+		if ( info.Relationship == RelationProcessorCore ) {
+			DenseIndex( coreMasks, info.ProcessorMask );
+		} else if ( ( info.Relationship == RelationCache ) && ( info.Cache.Level > lastLevelCache ) ) {
+			lastLevelCache = info.Cache.Level;
+		}
+	}
+	for ( const SYSTEM_LOGICAL_PROCESSOR_INFORMATION & info : infos ) {
+		if ( ( info.Relationship == RelationCache ) && ( info.Cache.Level == lastLevelCache ) ) {
+			DenseIndex( cacheMasks, info.ProcessorMask );
+		}
+	}
+
+	for ( uint32 index = 0; index < sizeof( ULONG_PTR ) * 8; ++index ) {
+		const ULONG_PTR bit = static_cast< ULONG_PTR >( 1 ) << index;
+		for ( uint64 coreIndex = 0; coreIndex < coreMasks.Length(); ++coreIndex ) {
+			if ( ( coreMasks[ coreIndex ] & bit ) == 0 ) {
+				continue;
+			}
+			cpuTopology_t::logicalCore_t & logicalCore = topology.logicalCores.Emplace();
+			logicalCore.index = index;
+			logicalCore.physicalCore = static_cast< uint32 >( coreIndex );
+			for ( uint64 cacheIndex = 0; cacheIndex < cacheMasks.Length(); ++cacheIndex ) {
+				if ( ( cacheMasks[ cacheIndex ] & bit ) != 0 ) {
+					logicalCore.cacheGroup = static_cast< uint32 >( cacheIndex );
+					break;
+				}
+			}
+			break;
+		}
+	}
+	topology.numPhysicalCores = static_cast< uint32 >( coreMasks.Length() );
+	topology.numCacheGroups = qpMath::Max( static_cast< uint32 >( cacheMasks.Length() ), 1u );
+	return topology;
+}
+
+bool qpThreadUtil::SetCurrentThreadAffinity( const uint32 logicalCore ) {
+	if ( !QP_VERIFY_MSG( logicalCore < sizeof( DWORD_PTR ) * 8, "Logical core is out of range." ) ) {
+		return false;
+	}
+	if ( SetThreadAffinityMask( GetCurrentThread(), static_cast< DWORD_PTR >( 1 ) << logicalCore ) == 0 ) {
+		qpDebug::Warning( "ThreadUtil: Failed to set thread affinity to core %u, error %lu.", logicalCore, GetLastError() );
+		return false;
+	}
+	return true;
+}
+
+void qpThreadUtil::SetCurrentThreadName( const char * name ) {
+	const qpWideString wideName = qpUTF8ToWide( name, static_cast< int >( strlen( name ) ) );
+	SetThreadDescription( GetCurrentThread(), wideName.c_str() );
+}
+
+#endif
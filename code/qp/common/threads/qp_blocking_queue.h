@@ -0,0 +1,119 @@
+#pragma once
+#include "qp_event_count.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/utilities/qp_utility.h"
+
+// Adds Push and Pop that sleep while the queue is full or empty on top of a bounded qpMPMCQueue or qpSPSCQueue.
+// Sleeping goes through event counts so the try versions stay lock free and waking costs a single load when
+// nobody is waiting. Close wakes everyone up, after that pushes fail and pops fail once the queue has run dry.
+template < typename _queue_ >
+class qpBlockingQueue {
+public:
+	using item_t = typename _queue_::item_t;
+
+	// the arguments are forwarded to the queue.
+	template < typename ... _args_ >
+	explicit qpBlockingQueue( _args_ &&... args ) : m_queue( qpForward< _args_ >( args )... ) {}
+
+	qpBlockingQueue( const qpBlockingQueue & other ) = delete;
+	qpBlockingQueue & operator=( const qpBlockingQueue & other ) = delete;
+
+	// wait for room, return false if the queue was closed.
+	bool Push( const item_t & item ) { return Emplace( item ); }
+	bool Push( item_t && item ) { return Emplace( qpMove( item ) ); }
+	template < typename ... _args_ >
+	bool Emplace( _args_ &&... args );
+	// waits for an item, returns false if the queue was closed and is empty.
+	bool Pop( item_t & outItem );
+
+	bool TryPush( const item_t & item ) { return TryEmplace( item ); }
+	bool TryPush( item_t && item ) { return TryEmplace( qpMove( item ) ); }
+	template < typename ... _args_ >
+	bool TryEmplace( _args_ &&... args );
+	bool TryPop( item_t & outItem );
+
+	void Close();
+	bool IsClosed() const { return m_closed.load( std::memory_order_acquire ); }
+
+	uint64 Capacity() const { return m_queue.Capacity(); }
+	uint64 Length() const { return m_queue.Length(); }
+	bool IsEmpty() const { return m_queue.IsEmpty(); }
+private:
+	_queue_ m_queue;
+	qpEventCount m_notEmpty;
+	qpEventCount m_notFull;
+	atomicBool_t m_closed = false;
+};
+
+template < typename _queue_ >
+template < typename ... _args_ >
+bool qpBlockingQueue< _queue_ >::Emplace( _args_ &&... args ) {
+	while ( true ) {
+		if ( IsClosed() ) {
+			return false;
+		}
+		if ( TryEmplace( qpForward< _args_ >( args )... ) ) {
+			return true;
+		}
+		const qpEventCount::key_t key = m_notFull.PrepareWait();
+		// anything popped after PrepareWait wakes us up, anything popped before is seen here.
+		if ( TryEmplace( qpForward< _args_ >( args )... ) ) {
+			m_notFull.CancelWait();
+			return true;
+		}
+		if ( IsClosed() ) {
+			m_notFull.CancelWait();
+			return false;
+		}
+		m_notFull.Wait( key );
+	}
+}
+
+template < typename _queue_ >
+bool qpBlockingQueue< _queue_ >::Pop( item_t & outItem ) {
+	while ( true ) {
+		if ( TryPop( outItem ) ) {
+			return true;
+		}
+		if ( IsClosed() ) {
+			// something could have been pushed right before the queue was closed.
+			return TryPop( outItem );
+		}
+		const qpEventCount::key_t key = m_notEmpty.PrepareWait();
+		if ( TryPop( outItem ) ) {
+			m_notEmpty.CancelWait();
+			return true;
+		}
+		if ( IsClosed() ) {
+			m_notEmpty.CancelWait();
+			return TryPop( outItem );
+		}
+		m_notEmpty.Wait( key );
+	}
+}
+
+template < typename _queue_ >
+template < typename ... _args_ >
+bool qpBlockingQueue< _queue_ >::TryEmplace( _args_ &&... args ) {
+	if ( !m_queue.TryEmplace( qpForward< _args_ >( args )... ) ) {
+		return false;
+	}
+	m_notEmpty.NotifyOne();
+	return true;
+}
+
+template < typename _queue_ >
+bool qpBlockingQueue< _queue_ >::TryPop( item_t & outItem ) {
+	if ( !m_queue.TryPop( outItem ) ) {
+		return false;
+	}
+	m_notFull.NotifyOne();
+	return true;
+}
+
+template < typename _queue_ >
+void qpBlockingQueue< _queue_ >::Close() {
+	m_closed.store( true, std::memory_order_release );
+	m_notEmpty.NotifyAll();
+	m_notFull.NotifyAll();
+}
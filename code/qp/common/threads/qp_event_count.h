@@ -0,0 +1,72 @@
+#pragma once
+#include "common/core/qp_types.h"
+#include <atomic>
+
+// Lets threads sleep until something changes without a mutex on the notifying side.
+// A waiter calls PrepareWait, checks its condition one last time and then either calls CancelWait or Wait.
+// Anything notified after PrepareWait wakes the waiter so checking the condition in between can't miss an update.
+// Notifying is a single load when nothing is waiting, sleeping goes through atomic wait which is a futex on linux
+// and WaitOnAddress on windows.
+class qpEventCount {
+public:
+	using key_t = uint32;
+
+	key_t PrepareWait() {
+		m_numWaiters.fetch_add( 1, std::memory_order_seq_cst );
+		return m_epoch.load( std::memory_order_seq_cst );
+	}
+	void CancelWait() { m_numWaiters.fetch_sub( 1, std::memory_order_relaxed ); }
+	void Wait( const key_t key ) {
+		m_epoch.wait( key, std::memory_order_seq_cst );
+		m_numWaiters.fetch_sub( 1, std::memory_order_relaxed );
+	}
+
+	// returns true if there was anyone to wake.
+	bool NotifyOne() {
+		if ( !BumpEpoch() ) {
+			return false;
+		}
+		m_epoch.notify_one();
+		return true;
+	}
+	bool NotifyAll() {
+		if ( !BumpEpoch() ) {
+			return false;
+		}
+		m_epoch.notify_all();
+		return true;
+	}
+
+	// wakes up to count waiters, returns how many there were to wake.
+	uint32 NotifyMany( const uint32 count ) {
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		const uint32 numWaiters = m_numWaiters.load( std::memory_order_relaxed );
+		if ( ( numWaiters == 0 ) || ( count == 0 ) ) {
+			return 0;
+		}
+		m_epoch.fetch_add( 1, std::memory_order_seq_cst );
+		if ( count >= numWaiters ) {
+			m_epoch.notify_all();
+			return numWaiters;
+		}
+		for ( uint32 index = 0; index < count; ++index ) {
+			m_epoch.notify_one();
+		}
+		return count;
+	}
+
+	uint32 NumWaiters() const { return m_numWaiters.load( std::memory_order_relaxed ); }
+private:
+	atomicUInt32_t m_epoch = 0;
+	atomicUInt32_t m_numWaiters = 0;
+
+	bool BumpEpoch() {
+		// pairs with the increment in PrepareWait so either the waiter sees the new state or we see the waiter.
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if ( m_numWaiters.load( std::memory_order_relaxed ) == 0 ) {
+			return false;
+		}
+		m_epoch.fetch_add( 1, std::memory_order_seq_cst );
+		return true;
+	}
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "common/core/qp_types.h"
+
+// A user mode execution context with its own stack that is switched to explicitly.
+// The default constructed fiber represents the calling thread so fibers have something to switch back to,
+// it has to be created and destroyed on the thread it represents.
+class qpFiber {
+public:
+	using fiberFunction_t = void ( * )( void * userData );
+
+	qpFiber();
+	qpFiber( const uint64 stackSize, fiberFunction_t func, void * userData );
+	~qpFiber();
+
+	qpFiber( const qpFiber & other ) = delete;
+	qpFiber & operator=( const qpFiber & other ) = delete;
+
+	// this has to be the fiber currently running on the calling thread.
+	void SwitchTo( qpFiber & fiber );
+
+	uint64 GetStackSize() const { return m_stackSize; }
+	bool IsThreadFiber() const { return m_func == NULL; }
+
+	// called by the platform code on the fiber's own stack.
+	static void Entry( qpFiber * fiber );
+private:
+	void * m_context = NULL;
+	uint64 m_stackSize = 0;
+	fiberFunction_t m_func = NULL;
+	void * m_userData = NULL;
+};
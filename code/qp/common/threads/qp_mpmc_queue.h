@@ -0,0 +1,131 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <new>
+
+// Bounded lock free queue that any number of threads can push to and pop from.
+// Every cell has a sequence number saying whether it is waiting for a push or a pop, so claiming a cell is a
+// single compare exchange on the push or pop position and no thread ever waits on another one holding a lock.
+// Based on Dmitry Vyukov's bounded MPMC queue. The queue doesn't grow, pushing to a full queue fails.
+template < typename _type_ >
+class qpMPMCQueue {
+public:
+	using item_t = _type_;
+
+	// capacity has to be a power of two, the cells are allocated through allocator which has to outlive the queue.
+	explicit qpMPMCQueue( const uint64 capacity, qpAllocator & allocator = qpGetDefaultAllocator() );
+	~qpMPMCQueue();
+
+	qpMPMCQueue( const qpMPMCQueue & other ) = delete;
+	qpMPMCQueue & operator=( const qpMPMCQueue & other ) = delete;
+
+	// return false if the queue is full, the item is only moved from if it was pushed.
+	bool TryPush( const _type_ & item ) { return TryEmplace( item ); }
+	bool TryPush( _type_ && item ) { return TryEmplace( qpMove( item ) ); }
+	template < typename ... _args_ >
+	bool TryEmplace( _args_ &&... args );
+	// returns false if the queue is empty.
+	bool TryPop( _type_ & outItem );
+
+	uint64 Capacity() const { return m_mask + 1; }
+	// only approximate while other threads are pushing or popping.
+	uint64 Length() const;
+	bool IsEmpty() const { return Length() == 0; }
+private:
+	struct cell_t {
+		atomicUInt64_t sequence = 0;
+		alignas( _type_ ) byte item[ sizeof( _type_ ) ];
+
+		_type_ * Item() { return std::launder( reinterpret_cast< _type_ * >( item ) ); }
+	};
+
+	cell_t * m_cells = NULL;
+	uint64 m_mask = 0;
+	qpAllocator * m_allocator = NULL;
+	// pushers and poppers only contend with each other when the queue is nearly empty.
+	alignas( 64 ) atomicUInt64_t m_pushPosition = 0;
+	alignas( 64 ) atomicUInt64_t m_popPosition = 0;
+};
+
+template < typename _type_ >
+qpMPMCQueue< _type_ >::qpMPMCQueue( const uint64 capacity, qpAllocator & allocator ) : m_mask( capacity - 1 ), m_allocator( &allocator ) {
+	QP_ASSERT_MSG( ( capacity > 1 ) && qpAllocationUtil::IsPowerOfTwo( capacity ), "Capacity has to be a power of two bigger than one." );
+	m_cells = static_cast< cell_t * >( m_allocator->Allocate( capacity * sizeof( cell_t ), alignof( cell_t ) ) );
+	QP_ASSERT_RELEASE_MSG( m_cells != NULL, "Queue allocator is out of memory." );
+	for ( uint64 index = 0; index < capacity; ++index ) {
+		new ( &m_cells[ index ] ) cell_t();
+		m_cells[ index ].sequence.store( index, std::memory_order_relaxed );
+	}
+}
+
+template < typename _type_ >
+qpMPMCQueue< _type_ >::~qpMPMCQueue() {
+	const uint64 pushPosition = m_pushPosition.load( std::memory_order_relaxed );
+	for ( uint64 position = m_popPosition.load( std::memory_order_relaxed ); position != pushPosition; ++position ) {
+		m_cells[ position & m_mask ].Item()->~_type_();
+	}
+	for ( uint64 index = 0; index <= m_mask; ++index ) {
+		m_cells[ index ].~cell_t();
+	}
+	m_allocator->Free( m_cells, Capacity() * sizeof( cell_t ) );
+}
+
+template < typename _type_ >
+template < typename ... _args_ >
+bool qpMPMCQueue< _type_ >::TryEmplace( _args_ &&... args ) {
+	uint64 position = m_pushPosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		cell_t & cell = m_cells[ position & m_mask ];
+		const uint64 sequence = cell.sequence.load( std::memory_order_acquire );
+		const int64 difference = static_cast< int64 >( sequence - position );
+		if ( difference == 0 ) {
+			// the cell is free for this position, try to claim it.
+			if ( m_pushPosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+				new ( cell.item ) _type_( qpForward< _args_ >( args )... );
+				cell.sequence.store( position + 1, std::memory_order_release );
+				return true;
+			}
+		} else if ( difference < 0 ) {
+			// the cell still holds the item from one lap ago.
+			return false;
+		} else {
+			// another thread pushed to this position first.
+			position = m_pushPosition.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+template < typename _type_ >
+bool qpMPMCQueue< _type_ >::TryPop( _type_ & outItem ) {
+	uint64 position = m_popPosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		cell_t & cell = m_cells[ position & m_mask ];
+		const uint64 sequence = cell.sequence.load( std::memory_order_acquire );
+		const int64 difference = static_cast< int64 >( sequence - ( position + 1 ) );
+		if ( difference == 0 ) {
+			if ( m_popPosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+				_type_ * item = cell.Item();
+				outItem = qpMove( *item );
+				item->~_type_();
+				// frees the cell for the push one lap ahead.
+				cell.sequence.store( position + m_mask + 1, std::memory_order_release );
+				return true;
+			}
+		} else if ( difference < 0 ) {
+			// nothing has been pushed to this position yet.
+			return false;
+		} else {
+			position = m_popPosition.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+template < typename _type_ >
+uint64 qpMPMCQueue< _type_ >::Length() const {
+	const uint64 popPosition = m_popPosition.load( std::memory_order_relaxed );
+	const uint64 pushPosition = m_pushPosition.load( std::memory_order_relaxed );
+	return ( pushPosition > popPosition ) ? pushPosition - popPosition : 0;
+}
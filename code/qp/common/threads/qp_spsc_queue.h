@@ -0,0 +1,112 @@
+#pragma once
+#include "qp/common/allocation/qp_allocator.h"
+#include "qp/common/allocation/qp_allocation_util.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <new>
+
+// Bounded wait free ring buffer between exactly one producer thread and one consumer thread.
+// The push and pop positions live on their own cache lines next to the producer's and consumer's cached copy of
+// the other position, so each side only reads the other's cache line when the ring looks full or empty.
+// The queue doesn't grow, pushing to a full queue fails.
+template < typename _type_ >
+class qpSPSCQueue {
+public:
+	using item_t = _type_;
+
+	// capacity has to be a power of two, the items are allocated through allocator which has to outlive the queue.
+	explicit qpSPSCQueue( const uint64 capacity, qpAllocator & allocator = qpGetDefaultAllocator() );
+	~qpSPSCQueue();
+
+	qpSPSCQueue( const qpSPSCQueue & other ) = delete;
+	qpSPSCQueue & operator=( const qpSPSCQueue & other ) = delete;
+
+	// producer only, return false if the queue is full and the item is only moved from if it was pushed.
+	bool TryPush( const _type_ & item ) { return TryEmplace( item ); }
+	bool TryPush( _type_ && item ) { return TryEmplace( qpMove( item ) ); }
+	template < typename ... _args_ >
+	bool TryEmplace( _args_ &&... args );
+
+	// consumer only, returns false if the queue is empty.
+	bool TryPop( _type_ & outItem );
+	// consumer only, the oldest item or NULL if the queue is empty. the item stays valid until it is popped.
+	_type_ * Peek();
+
+	uint64 Capacity() const { return m_mask + 1; }
+	// only approximate while the other side is pushing or popping.
+	uint64 Length() const;
+	bool IsEmpty() const { return Length() == 0; }
+private:
+	_type_ * m_items = NULL;
+	uint64 m_mask = 0;
+	qpAllocator * m_allocator = NULL;
+	// written by the producer.
+	alignas( 64 ) atomicUInt64_t m_pushPosition = 0;
+	uint64 m_cachedPopPosition = 0;
+	// written by the consumer.
+	alignas( 64 ) atomicUInt64_t m_popPosition = 0;
+	uint64 m_cachedPushPosition = 0;
+};
+
+template < typename _type_ >
+qpSPSCQueue< _type_ >::qpSPSCQueue( const uint64 capacity, qpAllocator & allocator ) : m_mask( capacity - 1 ), m_allocator( &allocator ) {
+	QP_ASSERT_MSG( qpAllocationUtil::IsPowerOfTwo( capacity ), "Capacity has to be a power of two." );
+	m_items = static_cast< _type_ * >( m_allocator->Allocate( capacity * sizeof( _type_ ), alignof( _type_ ) ) );
+	QP_ASSERT_RELEASE_MSG( m_items != NULL, "Queue allocator is out of memory." );
+}
+
+template < typename _type_ >
+qpSPSCQueue< _type_ >::~qpSPSCQueue() {
+	const uint64 pushPosition = m_pushPosition.load( std::memory_order_relaxed );
+	for ( uint64 position = m_popPosition.load( std::memory_order_relaxed ); position != pushPosition; ++position ) {
+		m_items[ position & m_mask ].~_type_();
+	}
+	m_allocator->Free( m_items, Capacity() * sizeof( _type_ ) );
+}
+
+template < typename _type_ >
+template < typename ... _args_ >
+bool qpSPSCQueue< _type_ >::TryEmplace( _args_ &&... args ) {
+	const uint64 position = m_pushPosition.load( std::memory_order_relaxed );
+	if ( position - m_cachedPopPosition == Capacity() ) {
+		m_cachedPopPosition = m_popPosition.load( std::memory_order_acquire );
+		if ( position - m_cachedPopPosition == Capacity() ) {
+			return false;
+		}
+	}
+	new ( &m_items[ position & m_mask ] ) _type_( qpForward< _args_ >( args )... );
+	m_pushPosition.store( position + 1, std::memory_order_release );
+	return true;
+}
+
+template < typename _type_ >
+bool qpSPSCQueue< _type_ >::TryPop( _type_ & outItem ) {
+	_type_ * item = Peek();
+	if ( item == NULL ) {
+		return false;
+	}
+	outItem = qpMove( *item );
+	item->~_type_();
+	m_popPosition.store( m_popPosition.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	return true;
+}
+
+template < typename _type_ >
+_type_ * qpSPSCQueue< _type_ >::Peek() {
+	const uint64 position = m_popPosition.load( std::memory_order_relaxed );
+	if ( position == m_cachedPushPosition ) {
+		m_cachedPushPosition = m_pushPosition.load( std::memory_order_acquire );
+		if ( position == m_cachedPushPosition ) {
+			return NULL;
+		}
+	}
+	return &m_items[ position & m_mask ];
+}
+
+template < typename _type_ >
+uint64 qpSPSCQueue< _type_ >::Length() const {
+	const uint64 popPosition = m_popPosition.load( std::memory_order_relaxed );
+	const uint64 pushPosition = m_pushPosition.load( std::memory_order_relaxed );
+	return ( pushPosition > popPosition ) ? pushPosition - popPosition : 0;
+}
@@ -22,6 +22,7 @@ void qpThread::RunJob( threadWorkFunctor_t && func ) {
 	m_threadData->isDetached.store( false );
 	m_thread = std::thread( [ job = qpMove( func ), threadDataRefPtr = m_threadData ]() mutable {
 			threadData_t & threadData = *threadDataRefPtr;
+			qpThreadUtil::SetCurrentThreadName( threadData.threadName.c_str() );
 			job( threadData );
 			threadData.isWorking.store( false );
 			qpDebug::Trace( "Thread '%s' shutting down.", threadData.threadName.c_str() );
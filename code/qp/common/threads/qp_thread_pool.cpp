@@ -1,13 +1,25 @@
 #include "engine.pch.h"
 #include "qp_thread_pool.h"
 #include "qp/common/string/qp_string.h"
-#include <condition_variable>
+#include "qp/common/time/qp_clock.h"
 
 namespace {
 	const uint32 s_minThreadPoolWorkers = 1;
 	const milliseconds_t s_threadPoolShutdownTimeoutMs = milliseconds_t( 1000 );
+	// every this many jobs a worker starts looking at a rotating priority instead of the highest one.
+	const uint32 s_starvationCheckInterval = 16;
+
+	uint32 NextRandom( uint32 & state ) {
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
 }
 
+thread_local qpThreadPool::worker_t * qpThreadPool::s_currentWorker = NULL;
+
 qpThreadPool::qpThreadPool() {
 }
 
@@ -20,14 +32,51 @@ qpThreadPool::~qpThreadPool () {
 }
 
 void qpThreadPool::Startup( const uint32 numWorkerThreads ) {
+	threadPoolParms_t parms;
+	parms.numWorkers = numWorkerThreads;
+	Startup( parms );
+}
+
+void qpThreadPool::Startup( const threadPoolParms_t & parms ) {
 	QP_ASSERT_MSG( !m_shuttingDown.load(), "Wait for thread pool to shutdown before starting it." );
-	const uint32 numWorkersNeeded = qpMath::Clamp( numWorkerThreads, s_minThreadPoolWorkers, MaxWorkers() );
+	uint32 maxWorkers = MaxWorkers();
+	qpList< uint32 > workerCores;
+	if ( parms.placement == workerPlacement_t::ONE_PER_PHYSICAL_CORE ) {
+		workerCores = qpThreadUtil::LogicalCoresOnePerPhysicalCore( qpThreadUtil::GetCpuTopology() );
+		if ( workerCores.Length() > 1 ) {
+			// the first core is left for the main thread.
+			maxWorkers = static_cast< uint32 >( workerCores.Length() - 1 );
+		} else {
+			qpDebug::Warning( "ThreadPool: Only one physical core, workers won't be pinned." );
+			workerCores.Clear();
+		}
+	}
+	const uint32 numWorkersRequested = ( parms.numWorkers != 0 ) ? parms.numWorkers : maxWorkers;
+	const uint32 numWorkersNeeded = qpMath::Clamp( numWorkersRequested, s_minThreadPoolWorkers, maxWorkers );
 	qpDebug::Trace( "ThreadPool: Creating with %u workers.", numWorkersNeeded );
+	m_numIdleSpins = parms.numIdleSpins;
+	m_numIdleYields = parms.numIdleYields;
+	m_mainThreadId = std::this_thread::get_id();
+
+	// all workers have to exist before any thread starts since they steal from each other.
+	m_workers.Reserve( numWorkersNeeded );
+	for ( uint32 index = 0; index < numWorkersNeeded; ++index ) {
+		worker_t * worker = new worker_t();
+		worker->index = index;
+		worker->randomState = index + 1;
+		if ( index + 1 < workerCores.Length() ) {
+			worker->logicalCore = static_cast< int >( workerCores[ index + 1 ] );
+		}
+		m_workers.Push( worker );
+	}
+
 	m_threads.Reserve( numWorkersNeeded );
 	qpString threadName;
 	for ( uint32 index = 0; index < numWorkersNeeded; ++index ) {
 		threadName.Format( "Worker %d", index );
-		m_threads.Emplace( new qpThread( threadName.c_str(), QP_BIND_FUNCTION( qpThreadPool::DoWork ) ) );
+		m_threads.Emplace( new qpThread( threadName.c_str(), [ this, index ]( const qpThread::threadData_t & threadData ) {
+			DoWork( index, threadData );
+		} ) );
 	}
 
 	m_started.store( true );
@@ -41,7 +90,7 @@ void qpThreadPool::Shutdown() {
 		qpDebug::Trace( "ThreadPool: Requesting to terminate thread '%s'.", thread->GetName() );
 		thread->Terminate();
 	}
-	m_jobConditionVar.notify_all();
+	m_idleEvent.NotifyAll();
 
 	for ( qpThread * thread : m_threads ) {
 		if ( thread->WaitForThread( s_threadPoolShutdownTimeoutMs ) ) {
@@ -54,31 +103,301 @@ void qpThreadPool::Shutdown() {
 		delete thread;
 	}
 	m_threads.Clear();
+
+	DeleteRemainingJobs();
+	for ( worker_t * worker : m_workers ) {
+		delete worker;
+	}
+	m_workers.Clear();
+
 	m_shuttingDown.store( false );
 	m_started.store( false );
 }
 
-void qpThreadPool::QueueJob( threadJobFunctor_t && job ) {
-	{
-		std::scoped_lock lock( m_jobQueueMutex );
-		m_jobsQueue.Emplace( qpMove( job ) );
+void qpThreadPool::QueueJob( threadJobFunctor_t && job, const jobPriority_t priority ) {
+	QP_ASSERT_MSG( priority < jobPriority_t::COUNT, "Invalid job priority." );
+	const int priorityIndex = static_cast< int >( priority );
+	job_t * newJob = m_jobAllocator.New( qpMove( job ) );
+
+	m_numPendingJobs.fetch_add( 1 );
+	worker_t * worker = GetCurrentWorker();
+	if ( worker != NULL ) {
+		worker->jobs[ priorityIndex ].Push( newJob );
+	} else {
+		m_injectionQueues[ priorityIndex ].Push( newJob );
+	}
+
+	WakeWorker();
+}
+
+void qpThreadPool::QueueJobs( threadJobFunctor_t * jobs, const uint64 numJobs, const jobPriority_t priority ) {
+	QueueJobs( numJobs, [ jobs ]( const uint64 index ) { return qpMove( jobs[ index ] ); }, priority );
+}
+
+void qpThreadPool::QueueMainThreadJob( threadJobFunctor_t && job ) {
+	m_mainThreadQueue.Push( m_jobAllocator.New( qpMove( job ) ) );
+}
+
+uint32 qpThreadPool::RunMainThreadJobs( const qpTimePoint & budget ) {
+	QP_ASSERT_MSG( IsMainThread(), "Main thread jobs can only be run on the main thread." );
+	const qpTimePoint start = qpClock::Now();
+	const int64 budgetUs = budget.AsMicroseconds().Get();
+
+	uint32 numJobsRun = 0;
+	while ( true ) {
+		job_t * job = m_mainThreadQueue.Pop();
+		if ( job == NULL ) {
+			break;
+		}
+		job->func();
+		m_jobAllocator.Delete( job );
+		++numJobsRun;
+
+		// checked after running so at least one job runs every call even with a tiny budget.
+		if ( ( qpClock::Now() - start ).AsMicroseconds().Get() >= budgetUs ) {
+			break;
+		}
+	}
+	return numJobsRun;
+}
+
+threadPoolStats_t qpThreadPool::GetStats() const {
+	threadPoolStats_t stats;
+	stats.numParks = m_numParks.load( std::memory_order_relaxed );
+	stats.numWakes = m_numWakes.load( std::memory_order_relaxed );
+	stats.numSpinHits = m_numSpinHits.load( std::memory_order_relaxed );
+	stats.numYieldHits = m_numYieldHits.load( std::memory_order_relaxed );
+	return stats;
+}
+
+void qpThreadPool::ResetStats() {
+	m_numParks.store( 0 );
+	m_numWakes.store( 0 );
+	m_numSpinHits.store( 0 );
+	m_numYieldHits.store( 0 );
+}
+
+bool qpThreadPool::TryRunPendingJob() {
+	job_t * job = FindJob( GetCurrentWorker() );
+	if ( job == NULL ) {
+		return false;
 	}
-	m_jobConditionVar.notify_one();
+	RunJob( job );
+	return true;
 }
 
-void qpThreadPool::DoWork( const qpThread::threadData_t & threadData ) {
-	threadJobFunctor_t job;
+void qpThreadPool::DoWork( const uint32 workerIndex, const qpThread::threadData_t & threadData ) {
+	worker_t * worker = m_workers[ workerIndex ];
+	s_currentWorker = worker;
+	if ( worker->logicalCore >= 0 ) {
+		qpThreadUtil::SetCurrentThreadAffinity( static_cast< uint32 >( worker->logicalCore ) );
+	}
 	while ( !threadData.shouldTerminate.load() ) {
-		{
-			std::unique_lock lock( m_jobQueueMutex );
-			m_jobConditionVar.wait( lock, [ & ]() { return !m_jobsQueue.IsEmpty() || threadData.shouldTerminate.load(); } );
-			if ( threadData.shouldTerminate.load() ) {
-				break;
+		job_t * job = FindJob( worker );
+		if ( job == NULL ) {
+			job = WaitForJob( worker, threadData );
+		}
+		if ( job != NULL ) {
+			RunJob( job );
+		}
+	}
+	s_currentWorker = NULL;
+}
+
+qpThreadPool::worker_t * qpThreadPool::GetCurrentWorker() const {
+	worker_t * worker = s_currentWorker;
+	if ( ( worker != NULL ) && ( worker->index < m_workers.Length() ) && ( m_workers[ worker->index ] == worker ) ) {
+		return worker;
+	}
+	// either not a worker or a worker from another pool.
+	return NULL;
+}
+
+qpThreadPool::job_t * qpThreadPool::FindJob( worker_t * worker ) {
+	// starting at a rotating priority every now and then keeps the lower priorities from starving.
+	int startPriority = 0;
+	if ( ( worker != NULL ) && ( ( ++worker->numJobsFound % s_starvationCheckInterval ) == 0 ) ) {
+		startPriority = static_cast< int >( ++worker->numStarvationChecks % NUM_JOB_PRIORITIES );
+	}
+
+	for ( int offset = 0; offset < NUM_JOB_PRIORITIES; ++offset ) {
+		job_t * job = FindJobWithPriority( worker, ( startPriority + offset ) % NUM_JOB_PRIORITIES );
+		if ( job != NULL ) {
+			return job;
+		}
+	}
+	return NULL;
+}
+
+qpThreadPool::job_t * qpThreadPool::FindJobWithPriority( worker_t * worker, const int priority ) {
+	job_t * job = NULL;
+	if ( ( worker != NULL ) && worker->jobs[ priority ].Pop( job ) ) {
+		return job;
+	}
+
+	job = m_injectionQueues[ priority ].Pop();
+	if ( job != NULL ) {
+		return job;
+	}
+
+	return StealJob( worker, priority );
+}
+
+qpThreadPool::job_t * qpThreadPool::StealJob( worker_t * thief, const int priority ) {
+	const uint32 numWorkers = NumWorkers();
+	if ( numWorkers == 0 ) {
+		return NULL;
+	}
+
+	uint32 randomState = ( thief != NULL ) ? thief->randomState : 0x9E3779B9u;
+	const uint32 startIndex = NextRandom( randomState ) % numWorkers;
+	if ( thief != NULL ) {
+		thief->randomState = randomState;
+	}
+
+	job_t * job = NULL;
+	for ( uint32 offset = 0; offset < numWorkers; ++offset ) {
+		worker_t * victim = m_workers[ ( startIndex + offset ) % numWorkers ];
+		if ( ( victim != thief ) && victim->jobs[ priority ].Steal( job ) ) {
+			return job;
+		}
+	}
+	return NULL;
+}
+
+void qpThreadPool::RunJob( job_t * job ) {
+	m_numPendingJobs.fetch_sub( 1 );
+	job->func();
+	m_jobAllocator.Delete( job );
+}
+
+void qpThreadPool::PublishJobs( job_t * const * jobs, const uint64 numJobs, const jobPriority_t priority ) {
+	const int priorityIndex = static_cast< int >( priority );
+	m_numPendingJobs.fetch_add( numJobs );
+	worker_t * worker = GetCurrentWorker();
+	if ( worker != NULL ) {
+		worker->jobs[ priorityIndex ].PushRange( jobs, static_cast< int64 >( numJobs ) );
+		return;
+	}
+
+	m_injectionQueues[ priorityIndex ].PushRange( jobs, numJobs );
+}
+
+void qpThreadPool::WakeWorker() {
+	// only costs a load unless a worker is actually asleep.
+	if ( m_idleEvent.NotifyOne() ) {
+		m_numWakes.fetch_add( 1, std::memory_order_relaxed );
+	}
+}
+
+void qpThreadPool::WakeWorkers( const uint64 numJobs ) {
+	const uint32 numWoken = m_idleEvent.NotifyMany( static_cast< uint32 >( qpMath::Min( numJobs, static_cast< uint64 >( m_workers.Length() ) ) ) );
+	if ( numWoken != 0 ) {
+		m_numWakes.fetch_add( numWoken, std::memory_order_relaxed );
+	}
+}
+
+qpThreadPool::job_t * qpThreadPool::WaitForJob( worker_t * worker, const qpThread::threadData_t & threadData ) {
+	// jobs tend to come in bursts so spinning for a bit is cheaper than sleeping and being woken up again.
+	for ( uint32 spin = 0; spin < m_numIdleSpins; ++spin ) {
+		qpThreadUtil::CpuPause();
+		if ( threadData.shouldTerminate.load( std::memory_order_relaxed ) ) {
+			return NULL;
+		}
+		if ( m_numPendingJobs.load( std::memory_order_relaxed ) != 0 ) {
+			job_t * job = FindJob( worker );
+			if ( job != NULL ) {
+				m_numSpinHits.fetch_add( 1, std::memory_order_relaxed );
+				return job;
 			}
-			if ( !QP_VERIFY_MSG( m_jobsQueue.Pop( job ), "Thread woke up to empty queue." ) ) {
-				continue;
+		}
+	}
+	for ( uint32 yield = 0; yield < m_numIdleYields; ++yield ) {
+		qpThreadUtil::YieldThread();
+		job_t * job = FindJob( worker );
+		if ( job != NULL ) {
+			m_numYieldHits.fetch_add( 1, std::memory_order_relaxed );
+			return job;
+		}
+	}
+
+	const qpEventCount::key_t key = m_idleEvent.PrepareWait();
+	// anything queued after PrepareWait will wake us up, anything queued before is found here.
+	job_t * job = FindJob( worker );
+	if ( ( job != NULL ) || threadData.shouldTerminate.load() ) {
+		m_idleEvent.CancelWait();
+		return job;
+	}
+	m_numParks.fetch_add( 1, std::memory_order_relaxed );
+	m_idleEvent.Wait( key );
+	return NULL;
+}
+
+void qpThreadPool::DeleteRemainingJobs() {
+	uint64 numDeletedJobs = 0;
+	job_t * job = NULL;
+	for ( int priority = 0; priority < NUM_JOB_PRIORITIES; ++priority ) {
+		for ( worker_t * worker : m_workers ) {
+			while ( worker->jobs[ priority ].Steal( job ) ) {
+				m_jobAllocator.Delete( job );
+				++numDeletedJobs;
 			}
 		}
-		job();
+		while ( ( job = m_injectionQueues[ priority ].Pop() ) != NULL ) {
+			m_jobAllocator.Delete( job );
+			++numDeletedJobs;
+		}
+	}
+	while ( ( job = m_mainThreadQueue.Pop() ) != NULL ) {
+		m_jobAllocator.Delete( job );
+		++numDeletedJobs;
+	}
+	m_numPendingJobs.store( 0 );
+
+	if ( numDeletedJobs != 0 ) {
+		qpDebug::Warning( "ThreadPool: Discarded %llu jobs that never ran.", numDeletedJobs );
+	}
+}
+
+void qpThreadPool::jobQueue_t::Push( job_t * job ) {
+	if ( ( numOverflowJobs.load( std::memory_order_acquire ) == 0 ) && jobs.TryPush( job ) ) {
+		return;
+	}
+	std::scoped_lock lock( overflowMutex );
+	overflow.Push( job );
+	numOverflowJobs.fetch_add( 1, std::memory_order_release );
+}
+
+void qpThreadPool::jobQueue_t::PushRange( job_t * const * newJobs, const uint64 numJobs ) {
+	uint64 numPushed = 0;
+	if ( numOverflowJobs.load( std::memory_order_acquire ) == 0 ) {
+		while ( ( numPushed < numJobs ) && jobs.TryPush( newJobs[ numPushed ] ) ) {
+			++numPushed;
+		}
+	}
+	if ( numPushed == numJobs ) {
+		return;
+	}
+	std::scoped_lock lock( overflowMutex );
+	overflow.Reserve( overflow.Length() + numJobs - numPushed );
+	for ( uint64 index = numPushed; index < numJobs; ++index ) {
+		overflow.Push( newJobs[ index ] );
+	}
+	numOverflowJobs.fetch_add( numJobs - numPushed, std::memory_order_release );
+}
+
+qpThreadPool::job_t * qpThreadPool::jobQueue_t::Pop() {
+	job_t * job = NULL;
+	if ( jobs.TryPop( job ) ) {
+		return job;
+	}
+	if ( numOverflowJobs.load( std::memory_order_acquire ) == 0 ) {
+		return NULL;
+	}
+	std::scoped_lock lock( overflowMutex );
+	if ( overflow.Pop( job ) ) {
+		numOverflowJobs.fetch_sub( 1, std::memory_order_release );
+		return job;
 	}
+	return NULL;
 }
@@ -1,28 +1,166 @@
 #pragma once
+#include "qp_event_count.h"
+#include "qp_mpmc_queue.h"
 #include "qp_thread.h"
+#include "qp_work_stealing_deque.h"
 #include "common/containers/qp_list.h"
 #include "common/containers/qp_queue.h"
+#include "qp/common/allocation/qp_pool_allocator.h"
+#include "qp/common/utilities/qp_inline_function.h"
+#include <coroutine>
 #include <mutex>
+#include <thread>
 
+enum class jobPriority_t {
+	CRITICAL,
+	HIGH,
+	NORMAL,
+	BACKGROUND,
+	COUNT
+};
+
+enum class workerPlacement_t {
+	ANY, // left to the os scheduler.
+	ONE_PER_PHYSICAL_CORE // every worker is pinned to its own physical core, skipping the core the main thread is likely on.
+};
+
+struct threadPoolParms_t {
+	uint32 numWorkers = 0; // 0 uses MaxWorkers.
+	workerPlacement_t placement = workerPlacement_t::ANY;
+	// an idle worker spins this many times looking for jobs, then yields this many times before it goes to sleep.
+	uint32 numIdleSpins = 256;
+	uint32 numIdleYields = 4;
+};
+
+struct threadPoolStats_t {
+	uint64 numParks = 0; // workers that went to sleep.
+	uint64 numWakes = 0; // sleeping workers woken up by new jobs.
+	uint64 numSpinHits = 0; // jobs found while spinning.
+	uint64 numYieldHits = 0; // jobs found after yielding.
+};
+
+// Work stealing thread pool.
+// Every worker owns a deque per priority that it pushes and pops its own jobs from, idle workers steal from the other workers.
+// Jobs queued from threads that aren't workers in the pool go through shared injection queues.
+// Higher priorities are always looked at first except for every few jobs where a worker starts at a rotating
+// priority instead, so lower priorities keep making progress while the higher ones are busy.
+// Jobs that have to run on the main thread go in a separate queue the main thread drains with RunMainThreadJobs.
 class qpThreadPool {
 public:
-	using threadJobFunctor_t = qpFunction< void() >;
+	// jobs are stored inline so queueing a job doesn't allocate for the functor.
+	using threadJobFunctor_t = qpInlineFunction< void() >;
 	qpThreadPool();
 	qpThreadPool( const uint32 numWorkerThreads );
 	~qpThreadPool();
-	
+
 	void Startup( const uint32 numWorkerThreads );
+	void Startup( const threadPoolParms_t & parms );
 	void Shutdown();
 
-	uint32 MaxWorkers() const { return m_threads.Length() != 0ull ? static_cast< uint32 >( m_threads.Length() ) : qpThreadUtil::NumHardwareThreads() - 1; }
+	uint32 MaxWorkers() const { return m_threads.Length() != 0ull ? static_cast< uint32 >( m_threads.Length() ) : qpMath::Max( qpThreadUtil::NumHardwareThreads(), 2u ) - 1; }
+	uint32 NumWorkers() const { return static_cast< uint32 >( m_workers.Length() ); }
+
+	void QueueJob( threadJobFunctor_t && job, const jobPriority_t priority = jobPriority_t::NORMAL );
+	// queues a batch of jobs publishing to the deque once per chunk instead of once per job,
+	// and only wakes as many sleeping workers as there are jobs. the jobs are moved out of the array.
+	void QueueJobs( threadJobFunctor_t * jobs, const uint64 numJobs, const jobPriority_t priority = jobPriority_t::NORMAL );
+	// same as above but the jobs are made by createJob( index ) for every index in [0, numJobs).
+	template < typename _createJob_ >
+	void QueueJobs( const uint64 numJobs, const _createJob_ & createJob, const jobPriority_t priority = jobPriority_t::NORMAL );
+	void QueueMainThreadJob( threadJobFunctor_t && job );
+	// runs main thread jobs until there are none left or the budget has been used up, returns the number of jobs run.
+	uint32 RunMainThreadJobs( const qpTimePoint & budget );
+	// the main thread is whichever thread started the pool.
+	bool IsMainThread() const { return std::this_thread::get_id() == m_mainThreadId; }
+	// runs one queued job on the calling thread if there is any, useful to help out instead of blocking.
+	bool TryRunPendingJob();
+
+	// counters for tuning the idle strategy, they are only approximate while the pool is running.
+	threadPoolStats_t GetStats() const;
+	void ResetStats();
+
+	struct scheduleAwaiter_t {
+		qpThreadPool * threadPool = NULL;
 
-	void QueueJob( threadJobFunctor_t && job );
+		bool await_ready() const noexcept { return false; }
+		void await_suspend( const std::coroutine_handle<> handle ) const { threadPool->QueueJob( [ handle ]() { handle.resume(); } ); }
+		void await_resume() const noexcept {}
+	};
+	// co_await pool.Schedule() continues the coroutine on one of the workers.
+	scheduleAwaiter_t Schedule() { return scheduleAwaiter_t { this }; }
 private:
+	struct job_t {
+		threadJobFunctor_t func;
+	};
+	enum {
+		NUM_JOB_PRIORITIES = static_cast< int >( jobPriority_t::COUNT ),
+		MAX_JOBS_PER_PUBLISH = 64,
+		JOB_QUEUE_CAPACITY = 4096
+	};
+	// queue for jobs handed over from other threads. pushing and popping is lock free until the ring fills up,
+	// then jobs go to a locked overflow queue until it has drained again so jobs from one thread stay in order.
+	struct jobQueue_t {
+		qpMPMCQueue< job_t * > jobs { JOB_QUEUE_CAPACITY };
+		qpQueue< job_t * > overflow;
+		std::mutex overflowMutex;
+		atomicUInt64_t numOverflowJobs = 0;
+
+		void Push( job_t * job );
+		void PushRange( job_t * const * newJobs, const uint64 numJobs );
+		job_t * Pop();
+	};
+	struct worker_t {
+		qpWorkStealingDeque< job_t * > jobs[ NUM_JOB_PRIORITIES ];
+		uint32 index = 0;
+		uint32 randomState = 0;
+		uint32 numJobsFound = 0;
+		uint32 numStarvationChecks = 0;
+		int logicalCore = -1; // pinned to this core when not negative.
+	};
+	static thread_local worker_t * s_currentWorker;
+
+	// jobs are queued and freed from every thread so they come from a lock free pool instead of the global heap.
+	qpTypedPoolAllocator< job_t, qpConcurrentPoolAllocator > m_jobAllocator { 256 };
 	qpList< qpThread * > m_threads;
-	qpQueue< threadJobFunctor_t > m_jobsQueue;
-	std::mutex m_jobQueueMutex;
-	std::condition_variable m_jobConditionVar;
+	qpList< worker_t * > m_workers;
+	jobQueue_t m_injectionQueues[ NUM_JOB_PRIORITIES ];
+	jobQueue_t m_mainThreadQueue;
+	std::thread::id m_mainThreadId;
+	qpEventCount m_idleEvent;
+	atomicUInt64_t m_numPendingJobs = 0;
+	uint32 m_numIdleSpins = 0;
+	uint32 m_numIdleYields = 0;
+	atomicUInt64_t m_numParks = 0;
+	atomicUInt64_t m_numWakes = 0;
+	atomicUInt64_t m_numSpinHits = 0;
+	atomicUInt64_t m_numYieldHits = 0;
 	atomicBool_t m_started = false;
 	atomicBool_t m_shuttingDown = false;
-	void DoWork( const qpThread::threadData_t & threadData );
+
+	void DoWork( const uint32 workerIndex, const qpThread::threadData_t & threadData );
+	worker_t * GetCurrentWorker() const;
+	job_t * FindJob( worker_t * worker );
+	job_t * FindJobWithPriority( worker_t * worker, const int priority );
+	job_t * StealJob( worker_t * thief, const int priority );
+	void RunJob( job_t * job );
+	void PublishJobs( job_t * const * jobs, const uint64 numJobs, const jobPriority_t priority );
+	void WakeWorker();
+	void WakeWorkers( const uint64 numJobs );
+	job_t * WaitForJob( worker_t * worker, const qpThread::threadData_t & threadData );
+	void DeleteRemainingJobs();
 };
+
+template < typename _createJob_ >
+void qpThreadPool::QueueJobs( const uint64 numJobs, const _createJob_ & createJob, const jobPriority_t priority ) {
+	QP_ASSERT_MSG( priority < jobPriority_t::COUNT, "Invalid job priority." );
+	job_t * newJobs[ MAX_JOBS_PER_PUBLISH ];
+	for ( uint64 first = 0; first < numJobs; first += MAX_JOBS_PER_PUBLISH ) {
+		const uint64 numNewJobs = qpMath::Min( numJobs - first, static_cast< uint64 >( MAX_JOBS_PER_PUBLISH ) );
+		// allocated up front so the jobs are published all at once.
+		for ( uint64 index = 0; index < numNewJobs; ++index ) {
+			newJobs[ index ] = m_jobAllocator.New( threadJobFunctor_t( createJob( first + index ) ) );
+		}
+		PublishJobs( newJobs, numNewJobs, priority );
+		WakeWorkers( numNewJobs );
+	}
+}
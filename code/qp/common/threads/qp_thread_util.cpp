@@ -0,0 +1,39 @@
+#include "engine.pch.h"
+#include "qp_thread_util.h"
+
+const cpuTopology_t & qpThreadUtil::GetCpuTopology() {
+	static const cpuTopology_t topology = [] () {
+		cpuTopology_t queriedTopology = QueryCpuTopology();
+		if ( queriedTopology.logicalCores.IsEmpty() ) {
+			qpDebug::Warning( "ThreadUtil: Failed to query cpu topology, treating every hardware thread as a physical core." );
+			const uint32 numHardwareThreads = qpMath::Max( NumHardwareThreads(), 1u );
+			for ( uint32 index = 0; index < numHardwareThreads; ++index ) {
+				cpuTopology_t::logicalCore_t & logicalCore = queriedTopology.logicalCores.Emplace();
+				logicalCore.index = index;
+				logicalCore.physicalCore = index;
+			}
+			queriedTopology.numPhysicalCores = numHardwareThreads;
+			queriedTopology.numCacheGroups = 1;
+		}
+		qpDebug::Trace( "ThreadUtil: %llu logical cores, %u physical cores, %u cache groups.",
+			queriedTopology.logicalCores.Length(), queriedTopology.numPhysicalCores, queriedTopology.numCacheGroups );
+		return queriedTopology;
+	}();
+	return topology;
+}
+
+qpList< uint32 > qpThreadUtil::LogicalCoresOnePerPhysicalCore( const cpuTopology_t & topology ) {
+	qpList< uint32 > logicalCores;
+	logicalCores.Reserve( topology.numPhysicalCores );
+	qpList< bool > physicalCoreTaken( static_cast< int >( topology.numPhysicalCores ), false );
+	for ( uint32 cacheGroup = 0; cacheGroup < topology.numCacheGroups; ++cacheGroup ) {
+		for ( const cpuTopology_t::logicalCore_t & logicalCore : topology.logicalCores ) {
+			if ( ( logicalCore.cacheGroup != cacheGroup ) || physicalCoreTaken[ logicalCore.physicalCore ] ) {
+				continue;
+			}
+			physicalCoreTaken[ logicalCore.physicalCore ] = true;
+			logicalCores.Push( logicalCore.index );
+		}
+	}
+	return logicalCores;
+}
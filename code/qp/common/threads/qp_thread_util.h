@@ -1,10 +1,48 @@
 #pragma once
+#include "common/containers/qp_list.h"
 #include "common/time/qp_time_point.h"
 #include <thread>
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#endif
+
+struct cpuTopology_t {
+	struct logicalCore_t {
+		uint32 index = 0; // index the os uses for the core, this is what affinities are set with.
+		uint32 physicalCore = 0;
+		uint32 cacheGroup = 0; // cores sharing the same last level cache, a CCX on AMD.
+	};
+	qpList< logicalCore_t > logicalCores;
+	uint32 numPhysicalCores = 0;
+	uint32 numCacheGroups = 0;
+};
 
 namespace qpThreadUtil {
 	static uint32 NumHardwareThreads() { return std::thread::hardware_concurrency(); }
 	static void SleepThread( const qpTimePoint & time ) {
 		std::this_thread::sleep_for( std::chrono::milliseconds( time.AsMilliseconds().Get() ) );
 	}
+	static void YieldThread() { std::this_thread::yield(); }
+	// hints the cpu that we're spinning, lets the other hyperthread on the core run and saves power.
+	static void CpuPause() {
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+		_mm_pause();
+#elif defined( _M_ARM64 )
+		__yield();
+#elif defined( __aarch64__ )
+		asm volatile( "yield" );
+#endif
+	}
+
+	// queried once and cached, falls back to one physical core per logical core if the os can't tell.
+	const cpuTopology_t & GetCpuTopology();
+	// one logical core for every physical core, cores sharing a cache group are next to each other.
+	qpList< uint32 > LogicalCoresOnePerPhysicalCore( const cpuTopology_t & topology );
+	// pins the calling thread to a single logical core.
+	bool SetCurrentThreadAffinity( const uint32 logicalCore );
+	// names the calling thread in debuggers and profilers.
+	void SetCurrentThreadName( const char * name );
+
+	// implemented per platform.
+	cpuTopology_t QueryCpuTopology();
 }
@@ -0,0 +1,162 @@
+#pragma once
+#include "qp/common/core/qp_types.h"
+#include "qp/common/core/qp_type_traits.h"
+#include "qp/common/containers/qp_list.h"
+#include "qp/common/debug/qp_debug.h"
+
+// Chase-Lev work stealing deque.
+// The owning thread pushes and pops at the bottom, any other thread can steal from the top.
+// Based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+// Items are copied racily by thieves so they have to be trivially copyable, typically pointers.
+template < typename _type_ >
+class qpWorkStealingDeque {
+public:
+	static_assert( IsTrivialToCopy< _type_ >, "qpWorkStealingDeque items have to be trivially copyable." );
+
+	explicit qpWorkStealingDeque( const int64 initialCapacity = 256 );
+	~qpWorkStealingDeque();
+
+	qpWorkStealingDeque( const qpWorkStealingDeque & other ) = delete;
+	qpWorkStealingDeque & operator=( const qpWorkStealingDeque & other ) = delete;
+
+	// owner only
+	void Push( const _type_ & item );
+	// publishes all the items at once, thieves can't see any of them until all of them are in.
+	void PushRange( const _type_ * items, const int64 numItems );
+	bool Pop( _type_ & outItem );
+
+	// any thread
+	bool Steal( _type_ & outItem );
+
+	int64 Length() const;
+	bool IsEmpty() const { return Length() <= 0; }
+private:
+	struct buffer_t {
+		int64 capacity = 0;
+		int64 mask = 0;
+		atomic_t< _type_ > * items = NULL;
+
+		explicit buffer_t( const int64 bufferCapacity )
+			: capacity( bufferCapacity ), mask( bufferCapacity - 1 ) {
+			items = new atomic_t< _type_ >[ bufferCapacity ];
+		}
+		~buffer_t() { delete[] items; }
+
+		_type_ Get( const int64 index ) const { return items[ index & mask ].load( std::memory_order_relaxed ); }
+		void Put( const int64 index, const _type_ & item ) { items[ index & mask ].store( item, std::memory_order_relaxed ); }
+	};
+
+	alignas( 64 ) atomicInt64_t m_top = 0;
+	alignas( 64 ) atomicInt64_t m_bottom = 0;
+	atomic_t< buffer_t * > m_buffer = NULL;
+	// buffers that have been outgrown, thieves might still be reading from them so they live until the deque dies.
+	qpList< buffer_t * > m_retiredBuffers;
+
+	buffer_t * Grow( buffer_t * buffer, const int64 top, const int64 bottom );
+};
+
+template< typename _type_ >
+qpWorkStealingDeque< _type_ >::qpWorkStealingDeque( const int64 initialCapacity ) {
+	QP_ASSERT_MSG( ( initialCapacity > 0 ) && ( ( initialCapacity & ( initialCapacity - 1 ) ) == 0 ), "Capacity has to be a power of two." );
+	m_buffer.store( new buffer_t( initialCapacity ), std::memory_order_relaxed );
+}
+
+template< typename _type_ >
+qpWorkStealingDeque< _type_ >::~qpWorkStealingDeque() {
+	delete m_buffer.load( std::memory_order_relaxed );
+	for ( buffer_t * buffer : m_retiredBuffers ) {
+		delete buffer;
+	}
+}
+
+template< typename _type_ >
+void qpWorkStealingDeque< _type_ >::Push( const _type_ & item ) {
+	const int64 bottom = m_bottom.load( std::memory_order_relaxed );
+	const int64 top = m_top.load( std::memory_order_acquire );
+	buffer_t * buffer = m_buffer.load( std::memory_order_relaxed );
+	if ( ( bottom - top ) > ( buffer->capacity - 1 ) ) {
+		buffer = Grow( buffer, top, bottom );
+	}
+	buffer->Put( bottom, item );
+	std::atomic_thread_fence( std::memory_order_release );
+	m_bottom.store( bottom + 1, std::memory_order_relaxed );
+}
+
+template< typename _type_ >
+void qpWorkStealingDeque< _type_ >::PushRange( const _type_ * items, const int64 numItems ) {
+	const int64 bottom = m_bottom.load( std::memory_order_relaxed );
+	const int64 top = m_top.load( std::memory_order_acquire );
+	buffer_t * buffer = m_buffer.load( std::memory_order_relaxed );
+	while ( ( bottom - top + numItems ) > buffer->capacity ) {
+		buffer = Grow( buffer, top, bottom );
+	}
+	for ( int64 index = 0; index < numItems; ++index ) {
+		buffer->Put( bottom + index, items[ index ] );
+	}
+	std::atomic_thread_fence( std::memory_order_release );
+	m_bottom.store( bottom + numItems, std::memory_order_relaxed );
+}
+
+template< typename _type_ >
+bool qpWorkStealingDeque< _type_ >::Pop( _type_ & outItem ) {
+	const int64 bottom = m_bottom.load( std::memory_order_relaxed ) - 1;
+	buffer_t * buffer = m_buffer.load( std::memory_order_relaxed );
+	m_bottom.store( bottom, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	int64 top = m_top.load( std::memory_order_relaxed );
+
+	if ( top > bottom ) {
+		// empty
+		m_bottom.store( bottom + 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	outItem = buffer->Get( bottom );
+	if ( top != bottom ) {
+		return true;
+	}
+
+	// last item, race against thieves for it.
+	const bool won = m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+	m_bottom.store( bottom + 1, std::memory_order_relaxed );
+	return won;
+}
+
+template< typename _type_ >
+bool qpWorkStealingDeque< _type_ >::Steal( _type_ & outItem ) {
+	int64 top = m_top.load( std::memory_order_acquire );
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	const int64 bottom = m_bottom.load( std::memory_order_acquire );
+
+	if ( top >= bottom ) {
+		return false;
+	}
+
+	buffer_t * buffer = m_buffer.load( std::memory_order_consume );
+	const _type_ item = buffer->Get( top );
+	if ( !m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+		// lost the race to another thief or the owner.
+		return false;
+	}
+
+	outItem = item;
+	return true;
+}
+
+template< typename _type_ >
+int64 qpWorkStealingDeque< _type_ >::Length() const {
+	const int64 bottom = m_bottom.load( std::memory_order_relaxed );
+	const int64 top = m_top.load( std::memory_order_relaxed );
+	return bottom - top;
+}
+
+template< typename _type_ >
+typename qpWorkStealingDeque< _type_ >::buffer_t * qpWorkStealingDeque< _type_ >::Grow( buffer_t * buffer, const int64 top, const int64 bottom ) {
+	buffer_t * newBuffer = new buffer_t( buffer->capacity * 2 );
+	for ( int64 index = top; index < bottom; ++index ) {
+		newBuffer->Put( index, buffer->Get( index ) );
+	}
+	m_retiredBuffers.Push( buffer );
+	m_buffer.store( newBuffer, std::memory_order_release );
+	return newBuffer;
+}
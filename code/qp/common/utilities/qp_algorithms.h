@@ -2,28 +2,185 @@
 #include "qp/common/core/qp_type_traits.h"
 #include "qp/common/core/qp_types.h"
 #include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <bit>
 #include <cstddef>
 #include <cstring>
 
+template < typename _type_ >
+void qpSwap( _type_ & a, _type_ & b ) {
+	_type_ temp = qpMove( a );
+	a = qpMove( b );
+	b = qpMove( temp );
+}
+
+// ordering used by qpSort and the sorted containers, lookups can be any type that compares with the items.
+template < typename _type_ >
+struct qpLess {
+	template < typename _a_, typename _b_ >
+	bool operator()( const _a_ & a, const _b_ & b ) const { return a < b; }
+};
+
+// first item in the sorted range that isn't less than value, end if there is none.
+// branchless, every step halves the range with a conditional move instead of a jump that mispredicts half the time.
+template < typename _type_, typename _lookup_, typename _less_ = qpLess< _type_ > >
+_type_ * qpLowerBound( _type_ * begin, _type_ * end, const _lookup_ & value, const _less_ & less = _less_() ) {
+	uint64 length = static_cast< uint64 >( end - begin );
+	if ( length == 0 ) {
+		return begin;
+	}
+	while ( length > 1 ) {
+		const uint64 half = length / 2;
+		begin = less( begin[ half ], value ) ? ( begin + half ) : begin;
+		length -= half;
+	}
+	return begin + ( less( *begin, value ) ? 1 : 0 );
+}
+
+// first item in the sorted range that value is less than, end if there is none.
+template < typename _type_, typename _lookup_, typename _less_ = qpLess< _type_ > >
+_type_ * qpUpperBound( _type_ * begin, _type_ * end, const _lookup_ & value, const _less_ & less = _less_() ) {
+	uint64 length = static_cast< uint64 >( end - begin );
+	if ( length == 0 ) {
+		return begin;
+	}
+	while ( length > 1 ) {
+		const uint64 half = length / 2;
+		begin = less( value, begin[ half ] ) ? begin : ( begin + half );
+		length -= half;
+	}
+	return begin + ( less( value, *begin ) ? 0 : 1 );
+}
+
 template < typename _type_ >
 _type_ * qpBinarySearch( _type_ * begin, _type_ * end, const _type_ & value ) {
-	int left = 0;
-	int right = static_cast< int >( end - begin );
-
-	while( left <= right ) {
-		int middle = ( left + right ) / 2;
-
-		_type_ * middlePtr = begin + middle;
-		if( *middlePtr < value ) {
-			left = ( middle + 1 );
-		} else if( value < *middlePtr ) {
-			right = ( middle - 1 );
-		} else {
-			return middlePtr;
+	_type_ * found = qpLowerBound( begin, end, value );
+	return ( ( found != end ) && !( value < *found ) ) ? found : end;
+}
+
+namespace qpAlgorithmsInternal {
+	enum {
+		INSERTION_SORT_THRESHOLD = 16
+	};
+
+	template < typename _type_, typename _less_ >
+	void InsertionSort( _type_ * begin, _type_ * end, const _less_ & less ) {
+		for ( _type_ * next = begin + 1; next < end; ++next ) {
+			if ( !less( *next, *( next - 1 ) ) ) {
+				continue;
+			}
+			_type_ item = qpMove( *next );
+			_type_ * hole = next;
+			do {
+				*hole = qpMove( *( hole - 1 ) );
+				--hole;
+			} while ( ( hole > begin ) && less( item, *( hole - 1 ) ) );
+			*hole = qpMove( item );
 		}
 	}
 
-	return end;
+	template < typename _type_, typename _less_ >
+	void SiftDown( _type_ * heap, uint64 index, const uint64 length, const _less_ & less ) {
+		_type_ item = qpMove( heap[ index ] );
+		while ( true ) {
+			uint64 child = index * 2 + 1;
+			if ( child >= length ) {
+				break;
+			}
+			if ( ( child + 1 < length ) && less( heap[ child ], heap[ child + 1 ] ) ) {
+				++child;
+			}
+			if ( !less( item, heap[ child ] ) ) {
+				break;
+			}
+			heap[ index ] = qpMove( heap[ child ] );
+			index = child;
+		}
+		heap[ index ] = qpMove( item );
+	}
+
+	template < typename _type_, typename _less_ >
+	void HeapSort( _type_ * begin, _type_ * end, const _less_ & less ) {
+		const uint64 length = static_cast< uint64 >( end - begin );
+		for ( uint64 index = length / 2; index > 0; --index ) {
+			SiftDown( begin, index - 1, length, less );
+		}
+		for ( uint64 heapLength = length; heapLength > 1; --heapLength ) {
+			qpSwap( begin[ 0 ], begin[ heapLength - 1 ] );
+			SiftDown( begin, 0, heapLength - 1, less );
+		}
+	}
+
+	// partitions around the median of the first, middle and last item, needs at least three items.
+	// returns where the pivot ended up, nothing before it is greater and nothing after it is less.
+	template < typename _type_, typename _less_ >
+	_type_ * Partition( _type_ * begin, _type_ * end, const _less_ & less ) {
+		_type_ * middle = begin + ( end - begin ) / 2;
+		_type_ * last = end - 1;
+		if ( less( *middle, *begin ) ) {
+			qpSwap( *middle, *begin );
+		}
+		if ( less( *last, *middle ) ) {
+			qpSwap( *last, *middle );
+			if ( less( *middle, *begin ) ) {
+				qpSwap( *middle, *begin );
+			}
+		}
+		// the first and last item now stop the scans below so they don't need bounds checks.
+		_type_ * pivot = begin + 1;
+		qpSwap( *middle, *pivot );
+		_type_ * left = pivot;
+		_type_ * right = last;
+		while ( true ) {
+			do {
+				++left;
+			} while ( less( *left, *pivot ) );
+			do {
+				--right;
+			} while ( less( *pivot, *right ) );
+			if ( left >= right ) {
+				break;
+			}
+			qpSwap( *left, *right );
+		}
+		if ( right != pivot ) {
+			qpSwap( *pivot, *right );
+		}
+		return right;
+	}
+
+	// leaves runs shorter than INSERTION_SORT_THRESHOLD unsorted for a final insertion sort over the whole range.
+	template < typename _type_, typename _less_ >
+	void IntroSort( _type_ * begin, _type_ * end, int depthLimit, const _less_ & less ) {
+		while ( end - begin > INSERTION_SORT_THRESHOLD ) {
+			if ( depthLimit == 0 ) {
+				// too many bad pivots, heap sort keeps the worst case at O(n log n).
+				HeapSort( begin, end, less );
+				return;
+			}
+			--depthLimit;
+			_type_ * pivot = Partition( begin, end, less );
+			// recursing into the smaller side keeps the stack depth logarithmic.
+			if ( pivot - begin < end - pivot ) {
+				IntroSort( begin, pivot, depthLimit, less );
+				begin = pivot + 1;
+			} else {
+				IntroSort( pivot + 1, end, depthLimit, less );
+				end = pivot;
+			}
+		}
+	}
+}
+
+// unstable introsort: quicksort that falls back to heap sort if it keeps picking bad pivots and insertion sort for short runs.
+template < typename _type_, typename _less_ = qpLess< _type_ > >
+void qpSort( _type_ * begin, _type_ * end, const _less_ & less = _less_() ) {
+	const uint64 length = static_cast< uint64 >( end - begin );
+	if ( length < 2 ) {
+		return;
+	}
+	qpAlgorithmsInternal::IntroSort( begin, end, 2 * static_cast< int >( std::bit_width( length ) ), less );
+	qpAlgorithmsInternal::InsertionSort( begin, end, less );
 }
 
 template < typename _type_ >
@@ -137,13 +294,6 @@ static uint64 qpCopyBytesOverlapped( void * to, const uint64 toSizeBytes, const
 	return qpCopyBytesOverlappedUnchecked( to, from, numBytes );
 }
 
-template < typename _type_ >
-void qpSwap( _type_ & a, _type_ & b ) {
-	const _type_ temp = a;
-	a = b;
-	b = temp;
-}
-
 template < typename _type_ >
 void qpZeroMemory( _type_ & memory ) {
 	memset( &memory, 0, sizeof( _type_ ) );
@@ -0,0 +1,43 @@
+#include "engine.pch.h"
+#include "qp_function.h"
+#include "qp/common/allocation/qp_pool_allocator.h"
+
+namespace {
+	const size_t s_functorSizeGranularity = 32;
+	const int s_numFunctorPools = 4; // functors up to 128 bytes are pooled
+
+	int FunctorPoolIndex( const size_t size ) { return static_cast< int >( ( size + s_functorSizeGranularity - 1 ) / s_functorSizeGranularity ) - 1; }
+
+	qpConcurrentPoolAllocator & GetFunctorPool( const int index ) {
+		// never destroyed since functors held by other statics can be freed after this one would have been.
+		static qpConcurrentPoolAllocator * pools = [] () {
+			qpConcurrentPoolAllocator * functorPools = static_cast< qpConcurrentPoolAllocator * >( ::operator new( sizeof( qpConcurrentPoolAllocator ) * s_numFunctorPools ) );
+			for ( int poolIndex = 0; poolIndex < s_numFunctorPools; ++poolIndex ) {
+				new ( &functorPools[ poolIndex ] ) qpConcurrentPoolAllocator( ( poolIndex + 1 ) * s_functorSizeGranularity, alignof( std::max_align_t ), 128 );
+			}
+			return functorPools;
+		}();
+		return pools[ index ];
+	}
+}
+
+void * qpFunctionInternal::AllocateFunctor( const size_t size ) {
+	const int poolIndex = FunctorPoolIndex( size );
+	if ( poolIndex >= s_numFunctorPools ) {
+		return ::operator new( size );
+	}
+	void * ptr = GetFunctorPool( poolIndex ).Allocate();
+	if ( ptr == NULL ) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void qpFunctionInternal::FreeFunctor( void * ptr, const size_t size ) {
+	const int poolIndex = FunctorPoolIndex( size );
+	if ( poolIndex >= s_numFunctorPools ) {
+		::operator delete( ptr );
+		return;
+	}
+	GetFunctorPool( poolIndex ).Free( ptr );
+}
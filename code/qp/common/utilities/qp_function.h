@@ -2,6 +2,12 @@
 #include "qp/common/core/qp_smart_pointers.h"
 #include "qp/common/debug/qp_debug.h"
 
+namespace qpFunctionInternal {
+	// functors are small and short lived so they come from lock free pools bucketed by size, big ones go to the heap.
+	void * AllocateFunctor( const size_t size );
+	void FreeFunctor( void * ptr, const size_t size );
+}
+
 template < typename >
 class qpFunction;
 
@@ -34,6 +40,10 @@ private:
 	public:
 		qpFunctorBase() = default;
 		virtual ~qpFunctorBase() = default;
+
+		// the destructor is virtual so delete passes the size of the actual functor.
+		static void * operator new( const size_t size ) { return qpFunctionInternal::AllocateFunctor( size ); }
+		static void operator delete( void * ptr, const size_t size ) { qpFunctionInternal::FreeFunctor( ptr, size ); }
 		virtual _return_ Invoke( _args_... ) const = 0;
 
 		QP_INTRUSIVE_REF_COUNTER;
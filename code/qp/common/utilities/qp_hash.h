@@ -0,0 +1,299 @@
+#pragma once
+#include "qp/common/core/qp_types.h"
+#include "qp/common/string/qp_char_traits.h"
+#include "qp/common/string/qp_string.h"
+#include <cstring>
+#include <type_traits>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+namespace qpHashUtil {
+	enum : uint64 {
+		// bytes are consumed in blocks of three independent 16 byte lanes so the multiplies can overlap.
+		BLOCK_SIZE = 48,
+		SECRET_0 = 0xa0761d6478bd642full,
+		SECRET_1 = 0xe7037ed1a0b428dbull,
+		SECRET_2 = 0x8ebc6af09c88c6e3ull,
+		SECRET_3 = 0x589965cc75374cc3ull
+	};
+
+	struct hashState_t {
+		uint64 lanes[ 3 ] {};
+	};
+
+	// spreads the bits of an integer over the whole hash so tables can use any of its bits.
+	constexpr uint64 MixInt( uint64 value ) {
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdull;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ull;
+		value ^= value >> 33;
+		return value;
+	}
+
+	// multiplies into 128 bits and folds the halves together.
+	constexpr uint64 Mum( const uint64 a, const uint64 b ) {
+		if ( !std::is_constant_evaluated() ) {
+#if defined( _MSC_VER )
+			uint64 high = 0;
+			const uint64 low = _umul128( a, b, &high );
+			return low ^ high;
+#else
+			const unsigned __int128 product = static_cast< unsigned __int128 >( a ) * b;
+			return static_cast< uint64 >( product ) ^ static_cast< uint64 >( product >> 64 );
+#endif
+		}
+		const uint64 lowLow = ( a & 0xffffffffull ) * ( b & 0xffffffffull );
+		const uint64 lowHigh = ( a & 0xffffffffull ) * ( b >> 32 );
+		const uint64 highLow = ( a >> 32 ) * ( b & 0xffffffffull );
+		const uint64 highHigh = ( a >> 32 ) * ( b >> 32 );
+		const uint64 cross = ( lowLow >> 32 ) + ( lowHigh & 0xffffffffull ) + ( highLow & 0xffffffffull );
+		const uint64 low = ( lowLow & 0xffffffffull ) | ( cross << 32 );
+		const uint64 high = highHigh + ( lowHigh >> 32 ) + ( highLow >> 32 ) + ( cross >> 32 );
+		return low ^ high;
+	}
+
+	// reads up to 8 bytes starting at byteOffset as a little endian integer, missing bytes are zero.
+	// every platform the engine runs on is little endian, so at runtime this is one or two loads for anything above 3 bytes.
+	template < typename _type_ >
+	constexpr uint64 ReadBytes( const _type_ * data, const uint64 byteOffset, const uint64 numBytes ) {
+		uint64 value = 0;
+		if ( !std::is_constant_evaluated() ) {
+			const byte * bytes = reinterpret_cast< const byte * >( data ) + byteOffset;
+			if ( numBytes == 8 ) {
+				memcpy( &value, bytes, 8 );
+				return value;
+			}
+			if ( numBytes >= 4 ) {
+				uint32 low = 0;
+				uint32 high = 0;
+				memcpy( &low, bytes, 4 );
+				memcpy( &high, bytes + numBytes - 4, 4 );
+				return low | ( static_cast< uint64 >( high ) << ( 8 * ( numBytes - 4 ) ) );
+			}
+			for ( uint64 index = 0; index < numBytes; ++index ) {
+				value |= static_cast< uint64 >( bytes[ index ] ) << ( 8 * index );
+			}
+			return value;
+		}
+		for ( uint64 index = 0; index < numBytes; ++index ) {
+			const uint64 byteIndex = byteOffset + index;
+			const uint64 character = static_cast< std::make_unsigned_t< _type_ > >( data[ byteIndex / sizeof( _type_ ) ] );
+			value |= ( ( character >> ( 8 * ( byteIndex % sizeof( _type_ ) ) ) ) & 0xffull ) << ( 8 * index );
+		}
+		return value;
+	}
+
+	constexpr hashState_t BeginHash( const uint64 seed ) {
+		const uint64 start = seed ^ Mum( seed ^ SECRET_0, SECRET_1 );
+		return hashState_t { { start, start, start } };
+	}
+
+	template < typename _type_ >
+	constexpr void HashBlock( hashState_t & state, const _type_ * data, const uint64 byteOffset ) {
+		state.lanes[ 0 ] = Mum( ReadBytes( data, byteOffset, 8 ) ^ SECRET_1, ReadBytes( data, byteOffset + 8, 8 ) ^ state.lanes[ 0 ] );
+		state.lanes[ 1 ] = Mum( ReadBytes( data, byteOffset + 16, 8 ) ^ SECRET_2, ReadBytes( data, byteOffset + 24, 8 ) ^ state.lanes[ 1 ] );
+		state.lanes[ 2 ] = Mum( ReadBytes( data, byteOffset + 32, 8 ) ^ SECRET_3, ReadBytes( data, byteOffset + 40, 8 ) ^ state.lanes[ 2 ] );
+	}
+
+	// hashes the last numBytes, at most a block, and mixes in the total length.
+	template < typename _type_ >
+	constexpr uint64 EndHash( const hashState_t & state, const _type_ * data, uint64 byteOffset, uint64 numBytes, const uint64 totalBytes ) {
+		uint64 hash = state.lanes[ 0 ] ^ state.lanes[ 1 ] ^ state.lanes[ 2 ];
+		while ( numBytes > 16 ) {
+			hash = Mum( ReadBytes( data, byteOffset, 8 ) ^ SECRET_1, ReadBytes( data, byteOffset + 8, 8 ) ^ hash );
+			byteOffset += 16;
+			numBytes -= 16;
+		}
+		const uint64 a = ReadBytes( data, byteOffset, ( numBytes > 8 ) ? 8 : numBytes );
+		const uint64 b = ( numBytes > 8 ) ? ReadBytes( data, byteOffset + 8, numBytes - 8 ) : 0;
+		return Mum( SECRET_1 ^ totalBytes, Mum( a ^ SECRET_1, b ^ hash ) );
+	}
+
+	// one shot version of qpHasher, gives the same hash as updating a hasher with the same bytes in any number of pieces.
+	template < typename _type_ >
+	constexpr uint64 HashItems( const _type_ * data, const uint64 count, const uint64 seed ) {
+		const uint64 numBytes = count * sizeof( _type_ );
+		hashState_t state = BeginHash( seed );
+		uint64 byteOffset = 0;
+		// the last block is left for EndHash, same as the hasher which can't know if more bytes follow.
+		while ( numBytes - byteOffset > BLOCK_SIZE ) {
+			HashBlock( state, data, byteOffset );
+			byteOffset += BLOCK_SIZE;
+		}
+		return EndHash( state, data, byteOffset, numBytes - byteOffset, numBytes );
+	}
+}
+
+// Streaming 64 bit hash in the style of wyhash, for hashing data that comes in pieces.
+// Usable at compile time, the result only depends on the bytes and not on how they were split up.
+class qpHasher {
+public:
+	explicit constexpr qpHasher( const uint64 seed = 0 ) : m_state( qpHashUtil::BeginHash( seed ) ) {}
+
+	// hashes the bytes of count items.
+	template < typename _type_ >
+	constexpr qpHasher & Update( const _type_ * data, const uint64 count );
+	qpHasher & UpdateBytes( const void * data, const uint64 numBytes ) { return Update( static_cast< const byte * >( data ), numBytes ); }
+
+	constexpr uint64 Finish() const { return qpHashUtil::EndHash( m_state, m_buffer, 0, m_bufferLength, m_totalBytes ); }
+private:
+	qpHashUtil::hashState_t m_state;
+	byte m_buffer[ qpHashUtil::BLOCK_SIZE ] {};
+	uint64 m_bufferLength = 0;
+	uint64 m_totalBytes = 0;
+
+	template < typename _type_ >
+	constexpr void Buffer( const _type_ * data, const uint64 byteOffset, const uint64 numBytes );
+};
+
+template < typename _type_ >
+constexpr qpHasher & qpHasher::Update( const _type_ * data, const uint64 count ) {
+	const uint64 numBytes = count * sizeof( _type_ );
+	m_totalBytes += numBytes;
+	if ( m_bufferLength + numBytes <= qpHashUtil::BLOCK_SIZE ) {
+		Buffer( data, 0, numBytes );
+		return *this;
+	}
+	uint64 byteOffset = 0;
+	if ( m_bufferLength > 0 ) {
+		// more bytes follow so the buffered block can be hashed once it is full.
+		byteOffset = qpHashUtil::BLOCK_SIZE - m_bufferLength;
+		Buffer( data, 0, byteOffset );
+		qpHashUtil::HashBlock( m_state, m_buffer, 0 );
+		m_bufferLength = 0;
+	}
+	while ( numBytes - byteOffset > qpHashUtil::BLOCK_SIZE ) {
+		qpHashUtil::HashBlock( m_state, data, byteOffset );
+		byteOffset += qpHashUtil::BLOCK_SIZE;
+	}
+	Buffer( data, byteOffset, numBytes - byteOffset );
+	return *this;
+}
+
+template < typename _type_ >
+constexpr void qpHasher::Buffer( const _type_ * data, const uint64 byteOffset, const uint64 numBytes ) {
+	if ( !std::is_constant_evaluated() ) {
+		memcpy( m_buffer + m_bufferLength, reinterpret_cast< const byte * >( data ) + byteOffset, numBytes );
+	} else {
+		for ( uint64 index = 0; index < numBytes; ++index ) {
+			m_buffer[ m_bufferLength + index ] = static_cast< byte >( qpHashUtil::ReadBytes( data, byteOffset + index, 1 ) );
+		}
+	}
+	m_bufferLength += numBytes;
+}
+
+inline uint64 qpHashBytes( const void * data, const uint64 numBytes, const uint64 seed = 0 ) {
+	return qpHashUtil::HashItems( static_cast< const byte * >( data ), numBytes, seed );
+}
+
+// hashes the characters of a string, a string literal hashed at compile time gives the same hash as at runtime.
+template < typename _type_ >
+constexpr uint64 qpHashString( const _type_ * string, const int length, const uint64 seed = 0 ) {
+	return qpHashUtil::HashItems( string, static_cast< uint64 >( length ), seed );
+}
+
+template < typename _type_ >
+constexpr uint64 qpHashString( const _type_ * string ) {
+	int length = 0;
+	while ( string[ length ] != CharTraits< _type_ >::NIL_CHAR ) {
+		++length;
+	}
+	return qpHashString( string, length );
+}
+
+// hashes the string as if every character had been lowered with CharTraits::ToLower, so strings that
+// qpStrIcmp says are equal hash the same.
+template < typename _type_ >
+uint64 qpHashStringNoCase( const _type_ * string, const int length, const uint64 seed = 0 ) {
+	qpHasher hasher( seed );
+	_type_ lowered[ 64 ];
+	for ( int start = 0; start < length; start += QP_ARRAY_LENGTH( lowered ) ) {
+		const int count = qpMath::Min( length - start, static_cast< int >( QP_ARRAY_LENGTH( lowered ) ) );
+		for ( int index = 0; index < count; ++index ) {
+			lowered[ index ] = CharTraits< _type_ >::ToLower( string[ start + index ] );
+		}
+		hasher.Update( lowered, static_cast< uint64 >( count ) );
+	}
+	return hasher.Finish();
+}
+
+// combines the hashes of the members of a key, for qpHash specializations of compound keys.
+constexpr uint64 qpHashCombine( const uint64 seed, const uint64 hash ) {
+	return qpHashUtil::Mum( seed ^ qpHashUtil::SECRET_0, hash ^ qpHashUtil::SECRET_1 );
+}
+
+// compile time hash of a string literal, e.g. "textures/cat.tga"_hash, equal to qpHashString and qpHash of the same string.
+consteval uint64 operator""_hash( const char * string, const size_t length ) {
+	return qpHashString( string, static_cast< int >( length ) );
+}
+
+// Hash used by the hash containers, specialize it to make a type usable as a key. Compound keys can hash
+// their members and combine them with qpHashCombine.
+// Strings, including c strings, are hashed by their content. Hashes of a string and a c string with the same
+// content are equal so string keyed containers can be looked up with a c string without building a string.
+template < typename _type_ >
+struct qpHash;
+
+template < typename _type_ > requires ( std::is_integral_v< _type_ > || std::is_enum_v< _type_ > )
+struct qpHash< _type_ > {
+	uint64 operator()( const _type_ value ) const { return qpHashUtil::MixInt( static_cast< uint64 >( value ) ); }
+};
+
+template < typename _type_ >
+struct qpHash< _type_ * > {
+	uint64 operator()( const _type_ * value ) const { return qpHashUtil::MixInt( reinterpret_cast< uintptr_t >( value ) ); }
+};
+
+template <>
+struct qpHash< const char * > {
+	uint64 operator()( const char * string ) const { return qpHashString( string, qpStrLen( string ) ); }
+};
+
+template <>
+struct qpHash< const wchar_t * > {
+	uint64 operator()( const wchar_t * string ) const { return qpHashString( string, qpStrLen( string ) ); }
+};
+
+template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
+struct qpHash< qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ > > {
+	uint64 operator()( const qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ > & string ) const { return qpHashString( string.c_str(), string.Length() ); }
+	uint64 operator()( const _type_ * string ) const { return qpHashString( string, qpStrLen( string ) ); }
+};
+
+// equality used by the hash containers, c strings are compared by their content.
+template < typename _type_ >
+struct qpEqual {
+	template < typename _other_ >
+	bool operator()( const _type_ & a, const _other_ & b ) const { return a == b; }
+};
+
+template <>
+struct qpEqual< const char * > {
+	bool operator()( const char * a, const char * b ) const { return qpStrCmp( a, b ) == 0; }
+};
+
+template <>
+struct qpEqual< const wchar_t * > {
+	bool operator()( const wchar_t * a, const wchar_t * b ) const { return qpStrCmp( a, b ) == 0; }
+};
+
+// hashes strings and c strings ignoring case, use it together with qpStrIEqual for case insensitive keys.
+struct qpStrIHash {
+	template < typename _type_ >
+	uint64 operator()( const _type_ * string ) const { return qpHashStringNoCase( string, qpStrLen( string ) ); }
+	template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
+	uint64 operator()( const qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ > & string ) const { return qpHashStringNoCase( string.c_str(), string.Length() ); }
+};
+
+// compares strings and c strings the same way as qpStrIcmp.
+struct qpStrIEqual {
+	template < typename _a_, typename _b_ >
+	bool operator()( const _a_ & a, const _b_ & b ) const { return qpStrIcmp( CString( a ), CString( b ) ) == 0; }
+private:
+	template < typename _type_ >
+	static const _type_ * CString( const _type_ * string ) { return string; }
+	template < typename _type_, bool _allowAlloc_, stringEncoding_t _encoding_, uint32 _staticBufferCapacity_ >
+	static const _type_ * CString( const qpStringBase< _type_, _allowAlloc_, _encoding_, _staticBufferCapacity_ > & string ) { return string.c_str(); }
+};
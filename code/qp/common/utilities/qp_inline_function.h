@@ -0,0 +1,110 @@
+#pragma once
+#include "qp/common/core/qp_type_traits.h"
+#include "qp/common/core/qp_types.h"
+#include "qp/common/debug/qp_debug.h"
+#include "qp/common/utilities/qp_utility.h"
+#include <cstddef>
+#include <new>
+
+template < typename, int _capacity_ = 56 >
+class qpInlineFunction;
+
+// Move only function that stores the callable inline and never allocates.
+// Callables that don't fit in _capacity_ bytes fail to compile, the default makes the whole function 64 bytes.
+template < typename _return_, typename ... _args_, int _capacity_ >
+class qpInlineFunction< _return_( _args_... ), _capacity_ > {
+public:
+	qpInlineFunction() = default;
+	qpInlineFunction( nullptr_t ) {}
+	template < typename _type_ > requires ( !IsSame< removeConstVolatile_t< removeReference_t< _type_ > >, qpInlineFunction > )
+	qpInlineFunction( _type_ && func );
+
+	qpInlineFunction( const qpInlineFunction & other ) = delete;
+	qpInlineFunction( qpInlineFunction && other ) noexcept;
+	~qpInlineFunction();
+
+	qpInlineFunction & operator=( const qpInlineFunction & rhs ) = delete;
+	qpInlineFunction & operator=( qpInlineFunction && rhs ) noexcept;
+	qpInlineFunction & operator=( nullptr_t );
+
+	_return_ operator()( _args_ ... args ) const;
+
+	operator bool() const { return m_functor != NULL; }
+private:
+	class qpFunctorBase {
+	public:
+		virtual ~qpFunctorBase() = default;
+		virtual _return_ Invoke( _args_... ) const = 0;
+		virtual qpFunctorBase * MoveTo( void * storage ) = 0;
+	};
+	template < typename _type_ >
+	class qpFunctor : public qpFunctorBase {
+	public:
+		template < typename _func_ >
+		qpFunctor( _func_ && func ) : m_func( qpForward< _func_ >( func ) ) {}
+		virtual ~qpFunctor() override = default;
+		virtual _return_ Invoke( _args_ ... args ) const override { return m_func( qpForward< _args_ >( args )... ); }
+		virtual qpFunctorBase * MoveTo( void * storage ) override { return new ( storage ) qpFunctor( qpMove( m_func ) ); }
+	private:
+		mutable _type_ m_func;
+	};
+
+	alignas( std::max_align_t ) uint8 m_storage[ _capacity_ ];
+	qpFunctorBase * m_functor = NULL;
+
+	void Reset();
+};
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+template< typename _type_ > requires ( !IsSame< removeConstVolatile_t< removeReference_t< _type_ > >, qpInlineFunction< _return_( _args_... ), _capacity_ > > )
+qpInlineFunction< _return_( _args_... ), _capacity_ >::qpInlineFunction( _type_ && func ) {
+	using functor_t = qpFunctor< removeConstVolatile_t< removeReference_t< _type_ > > >;
+	static_assert( sizeof( functor_t ) <= _capacity_, "Callable doesn't fit in qpInlineFunction, capture less or increase the capacity." );
+	static_assert( alignof( functor_t ) <= alignof( std::max_align_t ), "Callable is over aligned for qpInlineFunction." );
+	m_functor = new ( m_storage ) functor_t( qpForward< _type_ >( func ) );
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+qpInlineFunction< _return_( _args_... ), _capacity_ >::qpInlineFunction( qpInlineFunction && other ) noexcept {
+	if ( other.m_functor != NULL ) {
+		m_functor = other.m_functor->MoveTo( m_storage );
+		other.Reset();
+	}
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+qpInlineFunction< _return_( _args_... ), _capacity_ >::~qpInlineFunction() {
+	Reset();
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+qpInlineFunction< _return_( _args_... ), _capacity_ > & qpInlineFunction< _return_( _args_... ), _capacity_ >::operator=( qpInlineFunction && rhs ) noexcept {
+	if ( this != &rhs ) {
+		Reset();
+		if ( rhs.m_functor != NULL ) {
+			m_functor = rhs.m_functor->MoveTo( m_storage );
+			rhs.Reset();
+		}
+	}
+	return *this;
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+qpInlineFunction< _return_( _args_... ), _capacity_ > & qpInlineFunction< _return_( _args_... ), _capacity_ >::operator=( nullptr_t ) {
+	Reset();
+	return *this;
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+_return_ qpInlineFunction< _return_( _args_... ), _capacity_ >::operator()( _args_... args ) const {
+	QP_ASSERT( m_functor != NULL );
+	return m_functor->Invoke( qpForward< _args_ >( args )... );
+}
+
+template< typename _return_, typename ... _args_, int _capacity_ >
+void qpInlineFunction< _return_( _args_... ), _capacity_ >::Reset() {
+	if ( m_functor != NULL ) {
+		m_functor->~qpFunctorBase();
+		m_functor = NULL;
+	}
+}
@@ -2,8 +2,8 @@
 #include "qp/common/core/qp_type_traits.h"
 
 template < typename _type_ >
-QP_NO_DISCARD constexpr _type_ & qpForward( removeReference_t< _type_ > & arg ) noexcept {
-	return static_cast< _type_ & >( arg );
+QP_NO_DISCARD constexpr _type_ && qpForward( removeReference_t< _type_ > & arg ) noexcept {
+	return static_cast< _type_ && >( arg );
 }
 
 template < typename _type_ >
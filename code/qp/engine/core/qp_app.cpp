@@ -1,7 +1,14 @@
 #include "engine.pch.h"
 #include "qp_app.h"
+#include "qp/common/threads/qp_thread_pool.h"
 
-qpApp::qpApp() {
+namespace {
+	// time spent each frame on jobs queued for the main thread.
+	const qpTimePoint s_mainThreadJobBudget = milliseconds_t( 2 );
+	const uint64 s_frameAllocatorCapacity = 4 * 1024 * 1024;
+}
+
+qpApp::qpApp() : m_frameAllocator( s_frameAllocatorCapacity ) {
 }
 
 qpApp::~qpApp() {
@@ -17,7 +24,11 @@ void qpApp::Run() {
 	OnInit();
 
 	while ( m_isRunning ) {
+		if ( m_threadPool != NULL ) {
+			m_threadPool->RunMainThreadJobs( s_mainThreadJobBudget );
+		}
 		OnUpdate();
+		m_frameAllocator.Reset();
 	}
 
 	OnCleanup();
@@ -1,4 +1,7 @@
 #pragma once
+#include "qp/common/allocation/qp_linear_allocator.h"
+
+class qpThreadPool;
 
 class qpApp {
 public:
@@ -10,10 +13,18 @@ public:
 
 	bool IsRunning() const { return m_isRunning; }
 
+	// jobs queued on the pool's main thread queue are run once per frame.
+	void SetThreadPool( qpThreadPool * threadPool ) { m_threadPool = threadPool; }
+
+	// scratch memory for the main thread that is reset at the end of every frame.
+	qpLinearAllocator & GetFrameAllocator() { return m_frameAllocator; }
+
 	virtual void OnInit() = 0;
 	virtual void OnUpdate() = 0;
 	virtual void OnCleanup() = 0;
 
 private:
 	bool m_isRunning = false;
+	qpThreadPool * m_threadPool = NULL;
+	qpLinearAllocator m_frameAllocator;
 };
\ No newline at end of file
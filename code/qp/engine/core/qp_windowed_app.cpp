@@ -11,6 +11,7 @@
 #endif
 
 #include "qp_windowed_app.h"
+#include "qp/common/allocation/qp_memory_tracking.h"
 
 #if defined( QP_PLATFORM_WINDOWS )
 #include "qp/engine/platform/windows/window/qp_window_win32.h"
@@ -36,6 +37,7 @@ void qpWindowedApp::OnInit() {
 		m_graphicsAPI->RequestFramebufferResize();
 	} );
 
+	qpMemoryCategoryScope memoryScope( memoryCategory_t::RENDERER );
 #if defined( QP_D3D11 )
 	m_graphicsAPI = qpCreateUnique< qpD3D11 >();
 #elif defined( QP_VULKAN )
@@ -49,7 +51,11 @@ void qpWindowedApp::OnInit() {
 }
 
 void qpWindowedApp::OnUpdate() {
-	m_graphicsAPI->DrawFrame();
+	{
+		// swapchain recreation on resize allocates while drawing.
+		qpMemoryCategoryScope memoryScope( memoryCategory_t::RENDERER );
+		m_graphicsAPI->DrawFrame();
+	}
 	m_window->OnUpdate();
 }
 
@@ -9,8 +9,9 @@
 #include "qp/common/filesystem/qp_file.h"
 #include "qp/engine/debug/qp_log.h"
 #include "qp/common/containers/qp_array.h"
+#include "qp/common/containers/qp_flat_set.h"
 #include "qp/common/containers/qp_list.h"
-#include "qp/common/containers/qp_set.h"
+#include "qp/common/containers/qp_small_list.h"
 #include "qp/common/math/qp_quat.h"
 #include "qp/common/time/qp_clock.h"
 #include "qp/engine/resources/image/qp_image.h"
@@ -155,7 +156,7 @@ void qpVulkan::CreateInstance() {
 	createInfo.flags = 0;
 	createInfo.pApplicationInfo = &appInfo;
 
-	qpList< const char * > enabledExtensions {
+	qpSmallList< const char *, 4 > enabledExtensions {
 		VK_KHR_SURFACE_EXTENSION_NAME,
 		VK_EXT_DEBUG_REPORT_EXTENSION_NAME
 	};
@@ -275,13 +276,14 @@ static bool CheckDeviceExtensionSupport( VkPhysicalDevice device ) {
 	qpList< VkExtensionProperties > availableExtensions( extensionCount );
 	vkEnumerateDeviceExtensionProperties( device, NULL, &extensionCount, availableExtensions.Data() );
 
-	qpSet< qpString > requiredExtensions;
+	qpFlatSet< qpString > requiredExtensions;
+	requiredExtensions.Reserve( deviceExtensions.Length() );
 	for ( const char * extension : deviceExtensions ) {
-		requiredExtensions.Emplace( extension );
+		requiredExtensions.Insert( extension );
 	}
 
 	for ( const VkExtensionProperties & extension : availableExtensions ) {
-		requiredExtensions.Erase( extension.extensionName );
+		requiredExtensions.Remove( extension.extensionName );
 
 		if ( requiredExtensions.IsEmpty() ) {
 			return true;
@@ -339,8 +341,8 @@ void qpVulkan::PickPhysicalDevice() {
 void qpVulkan::CreateLogicalDevice() {
 	queueFamilyIndices_t indices = FindQueueFamilies( m_physicalDevice );
 
-	qpList< VkDeviceQueueCreateInfo > queueCreateInfos;
-	qpSet< uint32 > uniqueQueueFamilies { indices.graphicsFamily.GetValue(), indices.presentFamily.GetValue() };
+	qpSmallList< VkDeviceQueueCreateInfo, 2 > queueCreateInfos;
+	qpFlatSet< uint32 > uniqueQueueFamilies { indices.graphicsFamily.GetValue(), indices.presentFamily.GetValue() };
 
 	float queuePriority = 1.0f;
 
@@ -446,17 +448,17 @@ qpVulkan::swapchainSupportDetails_t qpVulkan::QuerySwapchainSupport( VkPhysicalD
 	return details;
 }
 
-VkSurfaceFormatKHR qpVulkan::ChooseSwapchainSurfaceFormat( const qpList< VkSurfaceFormatKHR > & availableFormats ) {
+VkSurfaceFormatKHR qpVulkan::ChooseSwapchainSurfaceFormat( const qpArrayView< VkSurfaceFormatKHR > & availableFormats ) {
 	for ( const VkSurfaceFormatKHR & availableFormat : availableFormats ) {
 		if ( availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR ) {
 			return availableFormat;
 		}
 	}
 
-	return availableFormats[ 0 ];
+	return availableFormats.Data()[ 0 ];
 }
 
-VkPresentModeKHR qpVulkan::ChooseSwapchainPresentMode( const qpList< VkPresentModeKHR > & availablePresentModes ) {
+VkPresentModeKHR qpVulkan::ChooseSwapchainPresentMode( const qpArrayView< VkPresentModeKHR > & availablePresentModes ) {
 	for ( const VkPresentModeKHR & availablePresentMode : availablePresentModes ) {
 		if ( availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR ) {
 			return availablePresentMode;
@@ -681,7 +683,7 @@ void qpVulkan::CreateGraphicsPipeline() {
 	scissor.offset = { 0, 0 };
 	scissor.extent = m_swapchainExtent;
 
-	qpList< VkDynamicState > dynamicStates = {
+	qpSmallList< VkDynamicState, 2 > dynamicStates = {
 	VK_DYNAMIC_STATE_VIEWPORT,
 	VK_DYNAMIC_STATE_SCISSOR
 	};
@@ -1012,7 +1014,7 @@ void qpVulkan::CreateDescriptorPool() {
 }
 
 void qpVulkan::CreateDescriptorSets() {
-	qpList< VkDescriptorSetLayout > layouts( MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout );
+	qpSmallList< VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT > layouts( MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout );
 	VkDescriptorSetAllocateInfo allocInfo {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	allocInfo.descriptorPool = m_descriptorPool;
@@ -4,6 +4,7 @@
 #include "qp/common/utilities/qp_optional.h"
 #include "qp/common/containers/qp_array_view.h"
 #include "qp/common/containers/qp_list.h"
+#include "qp/common/containers/qp_small_list.h"
 #include "qp/common/string/qp_string.h"
 #include <cstddef>
 #include <vulkan/vulkan_core.h>
@@ -26,8 +27,9 @@ private:
 	};
 	struct swapchainSupportDetails_t {
 		VkSurfaceCapabilitiesKHR capabilities {};
-		qpList< VkSurfaceFormatKHR > formats;
-		qpList< VkPresentModeKHR > presentModes;
+		// surfaces only support a handful of formats and present modes.
+		qpSmallList< VkSurfaceFormatKHR, 8 > formats;
+		qpSmallList< VkPresentModeKHR, 8 > presentModes;
 	};
 	void CreateInstance();
 	void SetupDebugMessenger();
@@ -38,8 +40,8 @@ private:
 	bool HasAllQueueFamilyIndices( const queueFamilyIndices_t & indices ) const;
 	queueFamilyIndices_t FindQueueFamilies( VkPhysicalDevice device );
 	swapchainSupportDetails_t QuerySwapchainSupport( VkPhysicalDevice device );
-	VkSurfaceFormatKHR ChooseSwapchainSurfaceFormat( const qpList< VkSurfaceFormatKHR > & availableFormats );
-	VkPresentModeKHR ChooseSwapchainPresentMode( const qpList< VkPresentModeKHR > & availablePresentModes );
+	VkSurfaceFormatKHR ChooseSwapchainSurfaceFormat( const qpArrayView< VkSurfaceFormatKHR > & availableFormats );
+	VkPresentModeKHR ChooseSwapchainPresentMode( const qpArrayView< VkPresentModeKHR > & availablePresentModes );
 	VkExtent2D ChooseSwapchainExtent( const VkSurfaceCapabilitiesKHR & capabilities );
 	void CreateSwapchain();
 	void CreateImageViews();
@@ -7,28 +7,21 @@ qpResource * qpImageLoader::LoadResource_Internal( const qpFile & file ) {
 	const qpFilePath & path = file.GetFilePath();
 	qpFilePath::stringType_t extension; 
 	path.GetExtension( extension );
-	qpResourceLoader * resourceLoader = GetImageLoaderFromExtension( extension );
-	if ( resourceLoader == NULL ) {
-		SetLastError( qpFormat( "No suitable image loader found for extension: \"%s\".", extension.c_str() ) );
-		return NULL;
-	}
-	if ( resourceLoader == this ) {
+	if ( extension == ".qpimage" ) {
 		qpImage * imageResource = new qpImage();
 		DeserializeResourceFromFile( file, imageResource );
 		return imageResource;
 	}
-
-	return resourceLoader->LoadResourceFromFile( file );
-}
-
-qpResourceLoader * qpImageLoader::GetImageLoaderFromExtension( const qpFilePath::stringType_t & ext ) {
-	if ( ext == ".tga" ) {
-		static qpTGALoader loader;
-		return &loader;
-	}
-	if ( ext == ".qpimage" ) {
-		return this;
+	if ( extension == ".tga" ) {
+		// the loader is local since loaders keep error state and images can be loaded on several threads at once.
+		qpTGALoader tgaLoader;
+		qpResource * resource = tgaLoader.LoadResourceFromFile( file );
+		if ( tgaLoader.HasError() ) {
+			SetLastError( tgaLoader.GetLastError() );
+		}
+		return resource;
 	}
 
+	SetLastError( qpFormat( "No suitable image loader found for extension: \"%s\".", extension.c_str() ) );
 	return NULL;
 }
@@ -4,6 +4,4 @@
 class qpImageLoader : public qpResourceLoader {
 protected:
 	virtual qpResource * LoadResource_Internal( const qpFile & file ) override;
-private:
-	qpResourceLoader * GetImageLoaderFromExtension( const qpFilePath::stringType_t & ext );
 };
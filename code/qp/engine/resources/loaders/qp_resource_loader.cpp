@@ -1,5 +1,6 @@
 #include "engine.pch.h"
 #include "qp_resource_loader.h"
+#include "qp/common/allocation/qp_scratch_allocator.h"
 #include "qp/engine/resources/qp_resource.h"
 
 qpResource * qpResourceLoader::LoadResource( const qpFilePath & filePath ) {
@@ -35,7 +36,9 @@ qpResource * qpResourceLoader::LoadResourceFromFile( const qpFile & file ) {
 
 void qpResourceLoader::DeserializeResourceFromFile( const qpFile & file, qpResource * resource ) {
 	QP_ASSERT( resource != NULL );
-	qpBinaryReadSerializer readSerializer( file );
+	// the file is only needed while deserializing so it is read into scratch memory.
+	qpScratchScope scratch;
+	qpBinaryReadSerializer readSerializer( file, scratch.GetAllocator() );
 	if ( !resource->Serialize( readSerializer ) ) {
 		SetLastError( "Failed to deserialize resource." );
 	}
@@ -1,11 +1,14 @@
 #include "engine.pch.h"
 #include "qp_tga_loader.h"
+#include "qp/common/allocation/qp_scratch_allocator.h"
 #include "qp/engine/resources/qp_binary_stream.h"
 #include "qp/engine/resources/image/qp_image.h"
 
 // http://www.paulbourke.net/dataformats/tga/
 qpResource * qpTGALoader::LoadResource_Internal( const qpFile & file ) {
-	qpList< byte > buffer;
+	// the file is only needed while parsing so it is read into scratch memory, the pixels are copied out of it.
+	qpScratchScope scratch;
+	qpList< byte > buffer( scratch.GetAllocator() );
 	file.Read( buffer );
 
 	qpBinaryStream stream;
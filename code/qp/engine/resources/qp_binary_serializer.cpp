@@ -6,3 +6,8 @@ qpBinaryReadSerializer::qpBinaryReadSerializer( const qpFile & file )
 	: qpBinarySerializer( serializationMode_t::READING ) {
 	file.Read( m_buffer );
 }
+
+qpBinaryReadSerializer::qpBinaryReadSerializer( const qpFile & file, qpAllocator & allocator )
+	: qpBinarySerializer( serializationMode_t::READING, allocator ) {
+	file.Read( m_buffer );
+}
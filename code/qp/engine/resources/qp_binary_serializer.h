@@ -76,6 +76,8 @@ public:
 protected:
 	qpBinarySerializer( const serializationMode_t state )
 		: m_mode( state ) {}
+	qpBinarySerializer( const serializationMode_t state, qpAllocator & allocator )
+		: m_mode( state ), m_buffer( allocator ) {}
 
 	serializationMode_t	m_mode = serializationMode_t::READING;
 	qpList< uint8_t > m_buffer;
@@ -90,6 +92,8 @@ public:
 		qpCopyBytesUnchecked( m_buffer.Data(), buffer, m_buffer.Length() );
 	}	
 	qpBinaryReadSerializer( const qpFile & file );
+	// reads the file into a buffer allocated from allocator, e.g. the scratch allocator when the serializer doesn't outlive a qpScratchScope.
+	qpBinaryReadSerializer( const qpFile & file, qpAllocator & allocator );
 
 	bool ReadAll() const { return m_offset == m_buffer.Length(); }
 };
@@ -2,43 +2,71 @@
 #include "qp_resource_registry.h"
 #include "loaders/qp_resource_loader.h"
 #include "loaders/qp_tga_loader.h"
-#include "qp/common/string/qp_string_util.h"
+#include "qp/common/allocation/qp_scratch_allocator.h"
+#include "qp/common/core/qp_unique_ptr.h"
+#include "qp/common/string/qp_char_traits.h"
+#include "qp/common/threads/qp_thread_pool.h"
 
 namespace {
-	qpResourceLoader & GetResourceLoaderForPath( const qpFilePath & filePath ) {
-		static qpImageLoader imageLoader;
-		return imageLoader;
+	// loaders keep error state so every load gets its own, loads can happen on several threads at once.
+	qpUniquePtr< qpResourceLoader > CreateResourceLoaderForPath( const qpFilePath & filePath ) {
+		return qpUniquePtr< qpResourceLoader >( new qpImageLoader() );
+	}
+
+	// resource names are case insensitive so the id is made from the lowercased name. only names of cached resources
+	// are interned, lookups just hash the name so they don't lock the string table or keep names that missed.
+	qpStringId ResourceNameToId( const char * resourceName, const bool intern ) {
+		qpScratchScope scratch;
+		const int length = qpStrLen( resourceName );
+		char * lowerName = static_cast< char * >( scratch.GetAllocator().Allocate( static_cast< uint64 >( length ) + 1, 1 ) );
+		for ( int index = 0; index < length; ++index ) {
+			lowerName[ index ] = CharTraits< char >::ToLower( resourceName[ index ] );
+		}
+		return intern ? qpStringId( lowerName, length ) : qpStringId::FromString( lowerName, length );
 	}
 }
 
 qpResourceRegistry::~qpResourceRegistry() {
+	m_resourcesByName.Clear();
 	for ( resourceEntry_t & entry : m_resourceEntries ) {
 		ClearEntry( entry );
 	}
 }
 
 const qpResource * qpResourceRegistry::LoadResource( const qpFilePath & filePath, const returnDefault_t defaultResource ) {
-	m_lastError.Clear();
+	{
+		std::scoped_lock lock( m_mutex );
+		m_lastError.Clear();
+
+		if ( filePath.IsEmpty() ) {
+			m_lastError = "Filepath can't be empty when loading resource";
+			qpDebug::Error( "qpResourceRegistry: %s!", m_lastError.c_str() );
+			return NULL;
+		}
 
-	if ( filePath.IsEmpty() ) {
-		m_lastError = "Filepath can't be empty when loading resource";
-		qpDebug::Error( "qpResourceRegistry: %s!", m_lastError.c_str() );
-		return NULL;
+		qpResource * resource = FindMutable( filePath.c_str() );
+		if ( resource != NULL ) {
+			return resource;
+		}
 	}
-	qpResourceLoader & resourceLoader = GetResourceLoaderForPath( filePath );
 
-	qpResource * resource = FindMutable( filePath.c_str() );
-	if ( resource != NULL ) {
-		return resource;
+	// the lock isn't held while loading so other resources can be loaded at the same time.
+	qpMemoryCategoryScope memoryScope( memoryCategory_t::RESOURCE );
+	qpUniquePtr< qpResourceLoader > resourceLoader = CreateResourceLoaderForPath( filePath );
+	qpResource * resource = resourceLoader->LoadResource( filePath );
+
+	std::scoped_lock lock( m_mutex );
+	qpResource * cachedResource = FindMutable( filePath.c_str() );
+	if ( cachedResource != NULL ) {
+		// another thread loaded the same resource while this one was loading.
+		delete resource;
+		return cachedResource;
 	}
-	resource = resourceLoader.LoadResource( filePath );
-	resourceEntry_t entry;
-	entry.resource = resource;
-	entry.name = qpStringUtil::Duplicate( filePath.c_str() );
-	CacheResource( entry );
-	if ( resourceLoader.HasError() ) {
-		qpDebug::Error( R"(qpResourceRegistry: Resource "%s" has error: "%s")", filePath.c_str(), resourceLoader.GetLastError().c_str() );
-		m_lastError = resourceLoader.GetLastError();
+
+	CacheResource( filePath.c_str(), resource );
+	if ( resourceLoader->HasError() ) {
+		qpDebug::Error( R"(qpResourceRegistry: Resource "%s" has error: "%s")", filePath.c_str(), resourceLoader->GetLastError().c_str() );
+		m_lastError = resourceLoader->GetLastError();
 		if ( defaultResource == returnDefault_t::RETURN_NULL ) {
 			return NULL;
 		}
@@ -47,7 +75,13 @@ const qpResource * qpResourceRegistry::LoadResource( const qpFilePath & filePath
 	return resource;
 }
 
+qpTask< const qpResource * > qpResourceRegistry::LoadResourceAsync( qpThreadPool & threadPool, const qpFilePath filePath, const returnDefault_t defaultResource ) {
+	co_await threadPool.Schedule();
+	co_return LoadResource( filePath, defaultResource );
+}
+
 bool qpResourceRegistry::SerializeResource( qpBinarySerializer & serializer, const qpResource * resource ) {
+	std::scoped_lock lock( m_mutex );
 	int entryIndex = FindEntryIndexForResource( resource );
 	QP_ASSERT( entryIndex != -1 );
 	resourceEntry_t & entry = m_resourceEntries[ entryIndex ];
@@ -55,16 +89,23 @@ bool qpResourceRegistry::SerializeResource( qpBinarySerializer & serializer, con
 }
 
 const qpResource * qpResourceRegistry::Find( const char * resourceName ) const {
+	std::scoped_lock lock( m_mutex );
 	return FindMutable( resourceName );
 }
 
+bool qpResourceRegistry::HasResourceError() const {
+	std::scoped_lock lock( m_mutex );
+	return !m_lastError.IsEmpty();
+}
+
+qpString qpResourceRegistry::GetLastResourceError() const {
+	std::scoped_lock lock( m_mutex );
+	return m_lastError;
+}
+
 qpResource * qpResourceRegistry::FindMutable( const char * resourceName ) const {
-	for ( resourceEntry_t & entry : m_resourceEntries ) {
-		if ( qpStrIcmp( entry.name, resourceName ) ) {
-			return entry.resource;
-		}
-	}
-	return NULL;
+	qpResource * const * resource = m_resourcesByName.Find( ResourceNameToId( resourceName, false ) );
+	return ( resource != NULL ) ? *resource : NULL;
 }
 
 int qpResourceRegistry::FindEntryIndexForResource( const qpResource * resource ) const {
@@ -77,13 +118,18 @@ int qpResourceRegistry::FindEntryIndexForResource( const qpResource * resource )
 	return -1;
 }
 
-void qpResourceRegistry::CacheResource( const resourceEntry_t & entry ) {
-	QP_ASSERT( Find( entry.name ) == NULL );
+void qpResourceRegistry::CacheResource( const char * resourceName, qpResource * resource ) {
+	resourceEntry_t entry;
+	entry.resource = resource;
+	entry.name = ResourceNameToId( resourceName, true );
+	QP_ASSERT( m_resourcesByName.Find( entry.name ) == NULL );
 	m_resourceEntries.Push( entry );
+	m_resourcesByName.Insert( entry.name, entry.resource );
+	qpMemoryTracking::TrackObject( entry.resource, memoryCategory_t::RESOURCE, entry.name.GetString() );
 }
 
 void qpResourceRegistry::ClearEntry( resourceEntry_t & entry ) {
+	qpMemoryTracking::UntrackObject( entry.resource );
 	delete entry.resource;
-	qpStringUtil::Free( entry.name );
 	entry = resourceEntry_t();
 }
@@ -1,8 +1,13 @@
 #pragma once
-#include "qp/common/containers/qp_list.h"
+#include "qp/common/allocation/qp_memory_tracking.h"
+#include "qp/common/containers/qp_hash_map.h"
+#include "qp/common/containers/qp_virtual_list.h"
 #include "qp_resource.h"
 #include "qp/common/filesystem/qp_file_path.h"
 #include "qp/common/string/qp_string.h"
+#include "qp/common/string/qp_string_id.h"
+#include "qp/common/jobs/qp_task.h"
+#include <mutex>
 
 // todo: remove returnDefault_t when there is a way to check the resource for error instead.
 enum class returnDefault_t {
@@ -11,27 +16,40 @@ enum class returnDefault_t {
 };
 
 class qpBinarySerializer;
+class qpThreadPool;
 class qpResourceRegistry {
 public:
 	~qpResourceRegistry();
 
 	const qpResource * LoadResource( const qpFilePath & filePath, const returnDefault_t defaultResource );
+	// loads the resource on one of the pool's workers, the awaiting coroutine continues on that worker.
+	qpTask< const qpResource * > LoadResourceAsync( qpThreadPool & threadPool, const qpFilePath filePath, const returnDefault_t defaultResource );
 	bool SerializeResource( qpBinarySerializer & serializer, const qpResource * resource );
 
 	const qpResource * Find( const char * resourceName ) const;
 
-	bool HasResourceError() const { return !m_lastError.IsEmpty(); }
-	const qpString & GetLastResourceError() const { return m_lastError; }
+	bool HasResourceError() const;
+	// returns a copy since another thread can replace the error as soon as the lock is released.
+	qpString GetLastResourceError() const;
 private:
+	enum : uint64 {
+		MAX_RESOURCE_ENTRIES = 64 * 1024
+	};
 	struct resourceEntry_t {
 		qpResource * resource = NULL;
-		char * name = NULL;
+		qpStringId name;
 	};
-	qpList< resourceEntry_t > m_resourceEntries;
+	// grows in place without copying the table, MAX_RESOURCE_ENTRIES only reserves address space.
+	qpVirtualList< resourceEntry_t > m_resourceEntries { MAX_RESOURCE_ENTRIES, memoryCategory_t::RESOURCE };
+	// keyed by the id of the lowercased name so names are compared ignoring case.
+	qpHashMap< qpStringId, qpResource * > m_resourcesByName { qpGetAllocator( memoryCategory_t::RESOURCE ) };
 	qpString m_lastError;
+	// guards the entries and the last error since resources can be loaded from several threads at once,
+	// the last error belongs to whichever load finished last.
+	mutable std::mutex m_mutex;
 
 	qpResource * FindMutable( const char * resourceName ) const;
 	int FindEntryIndexForResource( const qpResource * resource ) const;
-	void CacheResource( const resourceEntry_t & entry );
+	void CacheResource( const char * resourceName, qpResource * resource );
 	void ClearEntry( resourceEntry_t & entry );
 };